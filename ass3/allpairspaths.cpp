@@ -0,0 +1,439 @@
+#include <algorithm>
+#include <climits>
+#include <cstdint>
+#include <utility>
+
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+
+#include "allpairspaths.h"
+#include "dijkstraengine.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/** side of a Floyd-Warshall block, 64 x 64 costs take 16 KB */
+const int kBlock = 64;
+
+/** no path yet during Floyd-Warshall; it and any cost can be added
+    without overflow */
+const int kInfinity = INT_MAX / 2;
+
+/** a cost at least this large stands for no path, it can be below
+    kInfinity after negative weights were added to it */
+const int kUnreachable = kInfinity / 2;
+
+/** Floyd-Warshall is used from one edge per kDenseFraction pairs */
+const long long kDenseFraction = 16;
+
+/** for k in the block, in order: c[i][j] = min(c[i][j], a[i][k] + b[k][j])
+    a holds the rows of c and b the columns of c, at block column and
+    block row k; on the diagonal all three are the same block
+    nextC and nextA are the next-hop blocks of c and a, or nullptr */
+void relaxBlock(int* c, const int* a, const int* b, int* nextC,
+                const int* nextA, size_t stride) {
+    for (int k = 0; k < kBlock; ++k) {
+        const int* bk = b + k * stride;
+        for (int i = 0; i < kBlock; ++i) {
+            int aik = a[i * stride + k];
+            if (aik >= kUnreachable) continue;
+            aik = std::max(aik, -kUnreachable);
+            int* ci = c + i * stride;
+            if (nextC == nullptr) {
+#ifdef __AVX2__
+                __m256i through = _mm256_set1_epi32(aik);
+                for (int j = 0; j < kBlock; j += 8) {
+                    __m256i old = _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i*>(ci + j));
+                    __m256i viaK = _mm256_add_epi32(through,
+                        _mm256_loadu_si256(
+                            reinterpret_cast<const __m256i*>(bk + j)));
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(ci + j),
+                                        _mm256_min_epi32(old, viaK));
+                }
+#else
+                for (int j = 0; j < kBlock; ++j) {
+                    ci[j] = std::min(ci[j], aik + bk[j]);
+                }
+#endif
+                continue;
+            }
+            int hop = nextA[i * stride + k];
+            int* nexti = nextC + i * stride;
+#ifdef __AVX2__
+            __m256i through = _mm256_set1_epi32(aik);
+            __m256i hops = _mm256_set1_epi32(hop);
+            for (int j = 0; j < kBlock; j += 8) {
+                __m256i old = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(ci + j));
+                __m256i viaK = _mm256_add_epi32(through,
+                    _mm256_loadu_si256(
+                        reinterpret_cast<const __m256i*>(bk + j)));
+                __m256i better = _mm256_cmpgt_epi32(old, viaK);
+                __m256i oldHops = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(nexti + j));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(ci + j),
+                                    _mm256_min_epi32(old, viaK));
+                _mm256_storeu_si256(reinterpret_cast<__m256i*>(nexti + j),
+                                    _mm256_blendv_epi8(oldHops, hops,
+                                                       better));
+            }
+#else
+            for (int j = 0; j < kBlock; ++j) {
+                int viaK = aik + bk[j];
+                if (viaK < ci[j]) {
+                    ci[j] = viaK;
+                    nexti[j] = hop;
+                }
+            }
+#endif
+        }
+    }
+}
+
+/** relaxBlock for a block c apart from a and b, as are all blocks off
+    row and column k: the order of k no longer matters, so each row of
+    c stays in registers while every k goes past it */
+void relaxOtherBlock(int* c, const int* a, const int* b, int* nextC,
+                     const int* nextA, size_t stride) {
+    for (int i = 0; i < kBlock; ++i) {
+        const int* ai = a + i * stride;
+        int* ci = c + i * stride;
+#ifdef __AVX2__
+        // half a row, 32 costs, at a time in four registers
+        for (int half = 0; half < kBlock; half += 32) {
+            __m256i best[4];
+            __m256i hops[4] = {};
+            for (int q = 0; q < 4; ++q) {
+                best[q] = _mm256_loadu_si256(
+                    reinterpret_cast<const __m256i*>(ci + half + 8 * q));
+                if (nextC != nullptr) {
+                    hops[q] = _mm256_loadu_si256(reinterpret_cast<
+                        const __m256i*>(nextC + i * stride + half + 8 * q));
+                }
+            }
+            for (int k = 0; k < kBlock; ++k) {
+                if (ai[k] >= kUnreachable) continue;
+                __m256i through =
+                    _mm256_set1_epi32(std::max(ai[k], -kUnreachable));
+                const int* bk = b + k * stride + half;
+                for (int q = 0; q < 4; ++q) {
+                    __m256i viaK = _mm256_add_epi32(through,
+                        _mm256_loadu_si256(
+                            reinterpret_cast<const __m256i*>(bk + 8 * q)));
+                    if (nextC != nullptr) {
+                        __m256i better = _mm256_cmpgt_epi32(best[q], viaK);
+                        hops[q] = _mm256_blendv_epi8(hops[q],
+                            _mm256_set1_epi32(nextA[i * stride + k]),
+                            better);
+                    }
+                    best[q] = _mm256_min_epi32(best[q], viaK);
+                }
+            }
+            for (int q = 0; q < 4; ++q) {
+                _mm256_storeu_si256(
+                    reinterpret_cast<__m256i*>(ci + half + 8 * q), best[q]);
+                if (nextC != nullptr) {
+                    _mm256_storeu_si256(reinterpret_cast<__m256i*>(
+                        nextC + i * stride + half + 8 * q), hops[q]);
+                }
+            }
+        }
+#else
+        for (int k = 0; k < kBlock; ++k) {
+            int aik = ai[k];
+            if (aik >= kUnreachable) continue;
+            aik = std::max(aik, -kUnreachable);
+            const int* bk = b + k * stride;
+            if (nextC == nullptr) {
+                for (int j = 0; j < kBlock; ++j) {
+                    ci[j] = std::min(ci[j], aik + bk[j]);
+                }
+                continue;
+            }
+            int hop = nextA[i * stride + k];
+            int* nexti = nextC + i * stride;
+            for (int j = 0; j < kBlock; ++j) {
+                int viaK = aik + bk[j];
+                if (viaK < ci[j]) {
+                    ci[j] = viaK;
+                    nexti[j] = hop;
+                }
+            }
+        }
+#endif
+    }
+}
+
+/** Bellman-Ford from a virtual vertex with an edge of 0 to each one
+    gives potentials that make every weight w + p[from] - p[to] >= 0
+    a shortest path has at most n - 1 edges, so a change in round n
+    means a negative cycle; stopping there keeps the 64-bit potentials
+    far from overflow
+    return false on a negative cycle */
+bool findPotentials(const CsrGraph& graph,
+                    std::vector<std::int64_t>& potential) {
+    int n = graph.getNumVertices();
+    potential.assign(n, 0);
+    for (int round = 1; round <= n; ++round) {
+        bool changed = false;
+        for (int v = 0; v < n; ++v) {
+            for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+                std::int64_t through = potential[v] + graph.edgeWeight(e);
+                std::int64_t& to = potential[graph.edgeTarget(e)];
+                if (through < to) {
+                    to = through;
+                    changed = true;
+                }
+            }
+        }
+        if (!changed) return true;
+    }
+    return false;
+}
+
+}  // namespace
+
+/** constructor, empty graph */
+AllPairsPaths::AllPairsPaths()
+    : withNextHops(false), method(ApspMethod::Johnson) {}
+
+/** matrix for graph, not computed yet; Auto picks the method from
+    the density of the graph, see chooseMethod */
+AllPairsPaths::AllPairsPaths(std::shared_ptr<const CsrGraph> graph,
+                             bool withNextHops, ApspMethod method)
+    : graph(std::move(graph)), withNextHops(withNextHops), method(method) {
+    if (!this->graph) {
+        this->method = ApspMethod::Johnson;
+        return;
+    }
+    if (method == ApspMethod::Auto) {
+        this->method = chooseMethod(*this->graph);
+    }
+    size_t n = static_cast<size_t>(getNumVertices());
+    costs.assign(n * n, INT_MAX);
+    if (withNextHops) nextHops.assign(n * n, -1);
+}
+
+/** fill the matrix using pool
+    return false, leaving every cost INT_MAX, on a negative cycle or
+    if Johnson reweights an edge to INT_MAX / 2 or more */
+bool AllPairsPaths::compute(ThreadPool& pool) {
+    if (!graph) return true;
+    bool ok = method == ApspMethod::FloydWarshall ? floydWarshall(pool)
+                                                  : johnson(pool);
+    if (!ok) {
+        std::fill(costs.begin(), costs.end(), INT_MAX);
+        std::fill(nextHops.begin(), nextHops.end(), -1);
+    }
+    return ok;
+}
+
+/** Floyd-Warshall if graph has at least n * n / 16 edges,
+    otherwise Johnson */
+ApspMethod AllPairsPaths::chooseMethod(const CsrGraph& graph) {
+    long long n = graph.getNumVertices();
+    long long edges = graph.getNumEdges();
+    return edges * kDenseFraction >= n * n ? ApspMethod::FloydWarshall
+                                           : ApspMethod::Johnson;
+}
+
+/** return the method compute uses, never Auto */
+ApspMethod AllPairsPaths::getMethod() const { return method; }
+
+/** return number of rows and of columns */
+int AllPairsPaths::getNumVertices() const {
+    return graph ? graph->getNumVertices() : 0;
+}
+
+/** costs from vertex id from, indexed by vertex id */
+const int* AllPairsPaths::row(int from) const {
+    return costs.data() + static_cast<size_t>(from) * getNumVertices();
+}
+
+/** cost from vertex id from to vertex id to */
+int AllPairsPaths::cost(int from, int to) const { return row(from)[to]; }
+
+/** cost between two labels, INT_MAX if either is not in the graph
+    or there is no path */
+int AllPairsPaths::cost(const std::string& start,
+                        const std::string& end) const {
+    if (!graph) return INT_MAX;
+    int from = graph->findVertex(start);
+    int to = graph->findVertex(end);
+    if (from < 0 || to < 0) return INT_MAX;
+    return cost(from, to);
+}
+
+/** return true if the next-hop table was kept */
+bool AllPairsPaths::hasNextHops() const { return withNextHops; }
+
+/** vertex after from on a shortest path to to
+    -1 if from is to, there is no path, or no next-hop table */
+int AllPairsPaths::nextHop(int from, int to) const {
+    if (!withNextHops) return -1;
+    return nextHops[static_cast<size_t>(from) * getNumVertices() + to];
+}
+
+/** labels on the shortest path from start to end, start first
+    empty if there is no path or no next-hop table */
+std::vector<std::string> AllPairsPaths::path(const std::string& start,
+                                             const std::string& end) const {
+    std::vector<std::string> labels;
+    if (!withNextHops || cost(start, end) == INT_MAX) return labels;
+    int to = graph->findVertex(end);
+    for (int v = graph->findVertex(start); v >= 0; v = nextHop(v, to)) {
+        labels.push_back(graph->getLabel(v));
+    }
+    return labels;
+}
+
+/** blocked Floyd-Warshall, return false on a negative cycle */
+bool AllPairsPaths::floydWarshall(ThreadPool& pool) {
+    int n = getNumVertices();
+    // costs around a negative cycle fall without bound and would
+    // overflow, so cycles are found before the matrix is filled
+    std::vector<std::int64_t> potential;
+    if (graph->hasNegativeWeights() && !findPotentials(*graph, potential)) {
+        return false;
+    }
+    // padded to whole blocks; the padding has no edges
+    int blocks = (n + kBlock - 1) / kBlock;
+    size_t stride = static_cast<size_t>(blocks) * kBlock;
+    std::vector<int> matrix(stride * stride, kInfinity);
+    std::vector<int> next;
+    if (withNextHops) next.assign(stride * stride, -1);
+    for (size_t v = 0; v < stride; ++v) {
+        matrix[v * stride + v] = 0;
+    }
+    for (int v = 0; v < n; ++v) {
+        for (int e = graph->edgeBegin(v); e < graph->edgeEnd(v); ++e) {
+            size_t cell = v * stride + graph->edgeTarget(e);
+            if (graph->edgeWeight(e) < matrix[cell]) {
+                matrix[cell] = graph->edgeWeight(e);
+                if (withNextHops) next[cell] = graph->edgeTarget(e);
+            }
+        }
+    }
+
+    auto block = [&](std::vector<int>& cells, int blockRow,
+                     int blockColumn) -> int* {
+        if (cells.empty()) return nullptr;
+        return cells.data() + blockRow * kBlock * stride +
+            blockColumn * kBlock;
+    };
+    for (int k = 0; k < blocks; ++k) {
+        int* diagonal = block(matrix, k, k);
+        int* nextDiagonal = block(next, k, k);
+        relaxBlock(diagonal, diagonal, diagonal, nextDiagonal, nextDiagonal,
+                   stride);
+        // the rest of row and column k only need the diagonal block
+        pool.parallelFor(0, blocks, 1, [&](int first, int last, int) {
+            for (int b = first; b < last; ++b) {
+                if (b == k) continue;
+                relaxBlock(block(matrix, k, b), diagonal, block(matrix, k, b),
+                           block(next, k, b), nextDiagonal, stride);
+                relaxBlock(block(matrix, b, k), block(matrix, b, k),
+                           diagonal, block(next, b, k), block(next, b, k),
+                           stride);
+            }
+        });
+        // every other block only needs row and column k
+        pool.parallelFor(0, blocks, 1, [&](int first, int last, int) {
+            for (int i = first; i < last; ++i) {
+                if (i == k) continue;
+                for (int j = 0; j < blocks; ++j) {
+                    if (j == k) continue;
+                    relaxOtherBlock(block(matrix, i, j), block(matrix, i, k),
+                                    block(matrix, k, j), block(next, i, j),
+                                    block(next, i, k), stride);
+                }
+            }
+        });
+    }
+
+    for (int from = 0; from < n; ++from) {
+        for (int to = 0; to < n; ++to) {
+            size_t cell = from * stride + to;
+            size_t out = static_cast<size_t>(from) * n + to;
+            bool reached = from != to && matrix[cell] < kUnreachable;
+            costs[out] = from == to ? 0 : reached ? matrix[cell] : INT_MAX;
+            if (withNextHops) nextHops[out] = reached ? next[cell] : -1;
+        }
+    }
+    return true;
+}
+
+/** Dijkstra from every vertex, return false on a negative cycle */
+bool AllPairsPaths::johnson(ThreadPool& pool) {
+    int n = getNumVertices();
+    std::vector<std::int64_t> potential(n, 0);
+    std::shared_ptr<const CsrGraph> searched = graph;
+    if (graph->hasNegativeWeights()) {
+        if (!findPotentials(*graph, potential)) return false;
+        std::vector<std::string> labels;
+        std::vector<int> offsets(1, 0);
+        std::vector<int> targets;
+        std::vector<int> weights;
+        for (int v = 0; v < n; ++v) {
+            labels.push_back(graph->getLabel(v));
+            for (int e = graph->edgeBegin(v); e < graph->edgeEnd(v); ++e) {
+                int to = graph->edgeTarget(e);
+                std::int64_t reduced =
+                    graph->edgeWeight(e) + potential[v] - potential[to];
+                if (reduced > INT_MAX / 2) return false;
+                targets.push_back(to);
+                weights.push_back(static_cast<int>(reduced));
+            }
+            offsets.push_back(static_cast<int>(targets.size()));
+        }
+        searched = std::make_shared<const CsrGraph>(
+            std::move(labels), std::move(offsets), std::move(targets),
+            std::move(weights));
+    }
+
+    std::vector<DijkstraEngine> engines(pool.getNumThreads());
+    std::vector<std::vector<int>> stacks(pool.getNumThreads());
+    pool.parallelFor(0, n, 1, [&](int first, int last, int thread) {
+        DijkstraEngine& engine = engines[thread];
+        std::vector<int>& stack = stacks[thread];
+        for (int source = first; source < last; ++source) {
+            engine.run(*searched, source);
+            const std::vector<int>& distance = engine.getDistances();
+            int* costRow = costs.data() + static_cast<size_t>(source) * n;
+            for (int v = 0; v < n; ++v) {
+                if (distance[v] == INT_MAX) continue;
+                costRow[v] = static_cast<int>(
+                    distance[v] - potential[source] + potential[v]);
+            }
+            if (!withNextHops) continue;
+
+            // the next hop of v is that of its parent, or v itself if
+            // the parent is the source; walk up to a known one
+            const std::vector<int>& parent = engine.getPredecessors();
+            int* hopRow = nextHops.data() + static_cast<size_t>(source) * n;
+            for (int v = 0; v < n; ++v) {
+                if (hopRow[v] >= 0 || v == source ||
+                    distance[v] == INT_MAX) {
+                    continue;
+                }
+                int u = v;
+                while (parent[u] != source && hopRow[u] < 0) {
+                    stack.push_back(u);
+                    u = parent[u];
+                }
+                int hop = hopRow[u] >= 0 ? hopRow[u] : u;
+                hopRow[u] = hop;
+                for (int w : stack) {
+                    hopRow[w] = hop;
+                }
+                stack.clear();
+            }
+        }
+    });
+    return true;
+}
@@ -0,0 +1,100 @@
+/**
+ * Shortest-path costs between every pair of vertices of a CsrGraph, in
+ * one row-major block of n * n costs, INT_MAX where there is no path,
+ * with an optional next-hop table of the same shape for rebuilding paths
+ * Two methods fill it:
+ * Floyd-Warshall, for dense graphs, runs on blocks of 64 x 64 costs that
+ * stay in cache; each round does the diagonal block, then its row and
+ * column, then all other blocks in parallel on a ThreadPool. The inner
+ * min-plus loop uses AVX2 when the compiler targets it (for example
+ * with the CMake option ASS3_AVX2) and plain C++ otherwise
+ * Johnson, for sparse graphs, runs Dijkstra from every source in
+ * parallel; negative weights are first made non-negative with
+ * Bellman-Ford potentials
+ * Both accept negative weights, and both fail on a negative cycle,
+ * which Bellman-Ford finds in 64-bit costs before any matrix is filled
+ * Without a negative cycle, every shortest-path cost must stay below
+ * INT_MAX / 4 in size
+ */
+
+#ifndef ALLPAIRSPATHS_H
+#define ALLPAIRSPATHS_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "csrgraph.h"
+#include "threadpool.h"
+
+/** algorithm used by AllPairsPaths::compute */
+enum class ApspMethod { Auto, FloydWarshall, Johnson };
+
+class AllPairsPaths {
+ public:
+    /** constructor, empty graph */
+    AllPairsPaths();
+
+    /** matrix for graph, not computed yet; Auto picks the method from
+        the density of the graph, see chooseMethod */
+    AllPairsPaths(std::shared_ptr<const CsrGraph> graph, bool withNextHops,
+                  ApspMethod method = ApspMethod::Auto);
+
+    /** fill the matrix using pool
+        return false, leaving every cost INT_MAX, on a negative cycle or
+        if Johnson reweights an edge to INT_MAX / 2 or more */
+    bool compute(ThreadPool& pool);
+
+    /** Floyd-Warshall if graph has at least n * n / 16 edges,
+        otherwise Johnson */
+    static ApspMethod chooseMethod(const CsrGraph& graph);
+
+    /** return the method compute uses, never Auto */
+    ApspMethod getMethod() const;
+
+    /** return number of rows and of columns */
+    int getNumVertices() const;
+
+    /** costs from vertex id from, indexed by vertex id */
+    const int* row(int from) const;
+
+    /** cost from vertex id from to vertex id to */
+    int cost(int from, int to) const;
+
+    /** cost between two labels, INT_MAX if either is not in the graph
+        or there is no path */
+    int cost(const std::string& start, const std::string& end) const;
+
+    /** return true if the next-hop table was kept */
+    bool hasNextHops() const;
+
+    /** vertex after from on a shortest path to to
+        -1 if from is to, there is no path, or no next-hop table */
+    int nextHop(int from, int to) const;
+
+    /** labels on the shortest path from start to end, start first
+        empty if there is no path or no next-hop table */
+    std::vector<std::string> path(const std::string& start,
+                                  const std::string& end) const;
+
+ private:
+    /** graph the costs belong to */
+    std::shared_ptr<const CsrGraph> graph;
+
+    /** n * n costs */
+    std::vector<int> costs;
+
+    /** same shape as costs, empty without a next-hop table */
+    std::vector<int> nextHops;
+
+    bool withNextHops;
+    ApspMethod method;
+
+    /** blocked Floyd-Warshall, return false on a negative cycle */
+    bool floydWarshall(ThreadPool& pool);
+
+    /** Dijkstra from every vertex, return false on a negative cycle */
+    bool johnson(ThreadPool& pool);
+};  // end AllPairsPaths
+
+#endif  // ALLPAIRSPATHS_H
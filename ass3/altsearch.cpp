@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <climits>
+
+#include "altsearch.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+/** constructor, no memory is allocated until the first query */
+AltSearch::AltSearch() : settled(0) {}
+
+/** return the lowest cost from source to target, INT_MAX if target
+    cannot be reached
+    landmarks must have been built for graph */
+int AltSearch::run(const CsrGraph& graph, const LandmarkIndex& landmarks,
+                   int source, int target) {
+    path.clear();
+    settled = 0;
+    int n = graph.getNumVertices();
+    if (source < 0 || source >= n || target < 0 || target >= n) {
+        return INT_MAX;
+    }
+    if (static_cast<int>(distance.size()) < n) {
+        distance.resize(n, INT_MAX);
+        bound.resize(n, -1);
+        parent.resize(n, -1);
+    }
+    heap.reserve(n);
+
+    int startBound = landmarks.lowerBound(source, target);
+    if (startBound != INT_MAX) {
+        distance[source] = 0;
+        bound[source] = startBound;
+        touched.push_back(source);
+        heap.update(source, startBound);
+    }
+
+    while (!heap.empty()) {
+        int v = heap.pop();
+        ++settled;
+        if (v == target) break;
+        for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+            int u = graph.edgeTarget(e);
+            int cost = distance[v] + graph.edgeWeight(e);
+            if (cost >= distance[u]) continue;
+            // every vertex gets its bound before its first cost, so
+            // touched records each changed vertex exactly once
+            if (bound[u] < 0) {
+                touched.push_back(u);
+                bound[u] = landmarks.lowerBound(u, target);
+            }
+            // the target cannot be reached from u
+            if (bound[u] == INT_MAX) continue;
+            distance[u] = cost;
+            parent[u] = v;
+            heap.update(u, cost + bound[u]);
+        }
+    }
+
+    int cost = distance[target];
+    if (cost != INT_MAX) {
+        for (int v = target; v >= 0; v = parent[v]) {
+            path.push_back(v);
+        }
+        std::reverse(path.begin(), path.end());
+    }
+
+    for (int v : touched) {
+        distance[v] = INT_MAX;
+        bound[v] = -1;
+        parent[v] = -1;
+    }
+    touched.clear();
+    heap.clear();
+    return cost;
+}
+
+/** vertex ids on the path found by the last run, source first
+    empty if the target could not be reached */
+const std::vector<int>& AltSearch::getPath() const { return path; }
+
+/** number of vertices taken off the heap by the last run */
+int AltSearch::getSettledCount() const { return settled; }
@@ -0,0 +1,59 @@
+/**
+ * Point-to-point A* search guided by a LandmarkIndex
+ * The key of a vertex is its cost from the source plus the landmark lower
+ * bound on its cost to the target, so the search heads for the target
+ * and settles far fewer vertices than Dijkstra. The landmark bounds are
+ * consistent, so every vertex is settled at most once and the first time
+ * the target is settled its cost is final
+ * Only the vertices touched by a query are reset afterwards
+ * A search object is not thread safe, use one per thread
+ */
+
+#ifndef ALTSEARCH_H
+#define ALTSEARCH_H
+
+#include <vector>
+
+#include "csrgraph.h"
+#include "landmarkindex.h"
+#include "priorityqueues.h"
+
+class AltSearch {
+ public:
+    /** constructor, no memory is allocated until the first query */
+    AltSearch();
+
+    /** return the lowest cost from source to target, INT_MAX if target
+        cannot be reached
+        landmarks must have been built for graph */
+    int run(const CsrGraph& graph, const LandmarkIndex& landmarks,
+            int source, int target);
+
+    /** vertex ids on the path found by the last run, source first
+        empty if the target could not be reached */
+    const std::vector<int>& getPath() const;
+
+    /** number of vertices taken off the heap by the last run */
+    int getSettledCount() const;
+
+ private:
+    /** cost from the source, INT_MAX if not reached yet */
+    std::vector<int> distance;
+
+    /** lower bound to the target, -1 if not computed yet */
+    std::vector<int> bound;
+
+    /** previous vertex towards the source, -1 if none */
+    std::vector<int> parent;
+
+    /** vertices whose entries above must be reset after a run */
+    std::vector<int> touched;
+
+    IndexedDaryHeap<4> heap;
+
+    /** result of the last run */
+    std::vector<int> path;
+    int settled;
+};  // end AltSearch
+
+#endif  // ALTSEARCH_H
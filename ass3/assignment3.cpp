@@ -1,10 +1,29 @@
+#include <algorithm>
 #include <iostream>
 #include <climits>
+#include <cstdio>
+#include <fstream>
 #include <map>
+#include <memory>
+#include <numeric>
+#include <random>
 #include <sstream>
+#include <thread>
 #include <vector>
 
+#include "allpairspaths.h"
+#include "altsearch.h"
+#include "bidirectionaldijkstra.h"
+#include "chsearch.h"
+#include "components.h"
+#include "deltastepping.h"
+#include "dijkstraengine.h"
+#include "dynamicsssp.h"
 #include "graph.h"
+#include "parallelbfs.h"
+#include "typedcsr.h"
+#include "versionedgraph.h"
+#include "vertexorder.h"
 
 ////////////////////////////////////////////////////////////////////////////////
 // This is 80 characters - Keep all lines under 80 characters                 //
@@ -167,6 +186,15 @@ void testGraph2() {
     cout << isOK(graphOut.str(), "D H I M N "s)
         << "BFS from D" << endl;
 
+    // one state reused for several queries on a const graph
+    const Graph& constGraph = g;
+    TraversalState state;
+    graphOut.str("");
+    constGraph.breadthFirstTraversal("O", graphVisitor, state);
+    constGraph.depthFirstTraversal("D", graphVisitor, state);
+    cout << isOK(graphOut.str(), "O P Q R S T U D H M I N "s)
+        << "reused TraversalState" << endl;
+
     graphOut.str("");
     g.depthFirstTraversal("U", graphVisitor);
     cout << isOK(graphOut.str(), "U "s)
@@ -185,10 +213,1338 @@ void testGraph2() {
         << "Djisktra O" << endl;
 }
 
+// random graph with labels v0000 v0001 ..., built directly as a CsrGraph
+// so that Graph::add does not print every edge
+CsrGraph randomCsrGraph(int numVertices, int edgesPerVertex, int maxWeight,
+    unsigned seed) {
+    mt19937 random(seed);
+    vector<string> labels;
+    for (int v = 0; v < numVertices; ++v) {
+        string digits = to_string(v);
+        labels.push_back("v" + string(4 - digits.size(), '0') + digits);
+    }
+    vector<int> offsets{ 0 }, targets, weights;
+    for (int v = 0; v < numVertices; ++v) {
+        for (int e = 0; e < edgesPerVertex; ++e) {
+            targets.push_back(random() % numVertices);
+            weights.push_back(random() % (maxWeight + 1));
+        }
+        // rows are sorted by target, like a frozen Graph
+        sort(targets.begin() + offsets.back(), targets.end());
+        offsets.push_back(static_cast<int>(targets.size()));
+    }
+    return CsrGraph(labels, offsets, targets, weights);
+}
+
+// rows x cols grid with edges both ways between neighbors, labels g00000 ...
+CsrGraph gridCsrGraph(int rows, int cols) {
+    vector<string> labels;
+    vector<int> offsets{ 0 }, targets, weights;
+    for (int v = 0; v < rows * cols; ++v) {
+        string digits = to_string(v);
+        labels.push_back("g" + string(5 - digits.size(), '0') + digits);
+        int r = v / cols, c = v % cols;
+        // neighbors in increasing id order: up, left, right, down
+        if (r > 0) targets.push_back(v - cols);
+        if (c > 0) targets.push_back(v - 1);
+        if (c + 1 < cols) targets.push_back(v + 1);
+        if (r + 1 < rows) targets.push_back(v + cols);
+        weights.resize(targets.size(), 1 + v % 3);
+        offsets.push_back(static_cast<int>(targets.size()));
+    }
+    return CsrGraph(labels, offsets, targets, weights);
+}
+
+// cost and path of a point-to-point query as "9: O Q R S U"
+string pathString(const PathResult& result) {
+    ostringstream out;
+    out << result.cost << ":";
+    for (const string& label : result.path) {
+        out << " " << label;
+    }
+    return out.str();
+}
+
+void testShortestPath() {
+    cout << "testShortestPath" << endl;
+    Graph g;
+    g.readFile("graph2.txt");
+    cout << isOK(pathString(g.shortestPath("O", "U")), "9: O Q R S U"s)
+        << "O to U" << endl;
+    cout << isOK(pathString(g.shortestPath("A", "O")),
+        to_string(INT_MAX) + ":") << "A to O unreachable" << endl;
+    cout << isOK(pathString(g.shortestPath("S", "S")), "0: S"s)
+        << "S to S" << endl;
+
+    // removing Q->R forces the path through P, reverse edges follow
+    cout << isOK(g.remove("Q", "R"), true) << "remove Q R" << endl;
+    cout << isOK(g.getNumEdges(), 23) << "23 edges" << endl;
+    cout << isOK(pathString(g.shortestPath("O", "U")), "13: O P R S U"s)
+        << "O to U after remove" << endl;
+    g.add("Q", "R", 1);
+    cout << isOK(pathString(g.shortestPath("O", "U")), "9: O Q R S U"s)
+        << "O to U after add" << endl;
+
+    // agrees with the full search on a larger graph
+    CsrGraph csr = randomCsrGraph(2000, 3, 50, 7);
+    DijkstraEngine engine;
+    BidirectionalDijkstra search;
+    bool same = true;
+    for (int source = 0; source < 20; ++source) {
+        engine.run(csr, source);
+        for (int target = 0; target < 2000; target += 97) {
+            same = same && search.run(csr, source, target) ==
+                engine.getDistances()[target];
+        }
+    }
+    cout << isOK(same, true) << "bidirectional matches Dijkstra" << endl;
+}
+
+void testLandmarks() {
+    cout << "testLandmarks" << endl;
+    Graph g;
+    g.readFile("graph2.txt");
+    g.buildLandmarks(3);
+    cout << isOK(g.hasLandmarks(), true) << "landmarks built" << endl;
+    cout << isOK(pathString(g.shortestPath("O", "U")), "9: O Q R S U"s)
+        << "ALT O to U" << endl;
+    cout << isOK(pathString(g.shortestPath("D", "A")),
+        to_string(INT_MAX) + ":") << "ALT D to A unreachable" << endl;
+    cout << isOK(g.saveLandmarks("graph2.alt"), true) << "save" << endl;
+
+    // any change to the graph drops the tables
+    g.add("U", "O", 1);
+    cout << isOK(g.hasLandmarks(), false) << "dropped by add" << endl;
+    cout << isOK(g.loadLandmarks("graph2.alt"), false)
+        << "stale file rejected" << endl;
+    g.remove("U", "O");
+    cout << isOK(g.loadLandmarks("graph2.alt"), true) << "load" << endl;
+    cout << isOK(pathString(g.shortestPath("O", "T")), "8: O Q R S T"s)
+        << "ALT O to T after load" << endl;
+    remove("graph2.alt");
+
+    // same costs as Dijkstra, far fewer vertices settled
+    CsrGraph grid = gridCsrGraph(100, 100);
+    LandmarkIndex index;
+    index.build(grid, 8);
+    AltSearch alt;
+    DijkstraEngine engine;
+    bool same = true;
+    long long altSettled = 0, reached = 0;
+    for (int source = 0; source < 10000; source += 1237) {
+        engine.run(grid, source);
+        for (int target = 0; target < 10000; target += 911) {
+            same = same && alt.run(grid, index, source, target) ==
+                engine.getDistances()[target];
+            altSettled += alt.getSettledCount();
+            reached += 10000;
+        }
+    }
+    cout << isOK(same, true) << "ALT matches Dijkstra" << endl;
+    cout << isOK(altSettled * 4 < reached, true) << "ALT prunes" << endl;
+}
+
+// true if path is a chain of edges of csr from source to target of the
+// given total cost
+bool isPathOfCost(const CsrGraph& csr, const vector<int>& path, int source,
+    int target, int cost) {
+    if (path.empty() || path.front() != source || path.back() != target) {
+        return false;
+    }
+    int total = 0;
+    for (size_t i = 1; i < path.size(); ++i) {
+        int best = INT_MAX;
+        for (int e = csr.edgeBegin(path[i - 1]); e < csr.edgeEnd(path[i - 1]);
+            ++e) {
+            if (csr.edgeTarget(e) == path[i]) best = csr.edgeWeight(e);
+        }
+        if (best == INT_MAX) return false;
+        total += best;
+    }
+    return total == cost;
+}
+
+void testContractionHierarchy() {
+    cout << "testContractionHierarchy" << endl;
+    Graph g;
+    g.readFile("graph1.txt");
+    cout << isOK(g.buildContractionHierarchy(), true) << "CH built" << endl;
+    g.shortestPath("A", "F", weight, previous);
+    graphCostDisplay();
+    cout << isOK(graphOut.str(), "B(1) C(2) via [B] D(3) via [B C] "s +
+        "E(4) via [B C D] F(5) via [B C D E] ") << "CH A to F" << endl;
+    cout << isOK(pathString(g.shortestPath("A", "G")), "4: A H G"s)
+        << "CH A to G" << endl;
+    cout << isOK(pathString(g.shortestPath("A", "X")),
+        to_string(INT_MAX) + ":") << "CH A to X unreachable" << endl;
+    g.add("A", "G", 1);
+    cout << isOK(g.hasContractionHierarchy(), false) << "dropped by add"
+        << endl;
+
+    for (const CsrGraph& csr : { gridCsrGraph(60, 60),
+        randomCsrGraph(1000, 3, 20, 11) }) {
+        ContractionHierarchy ch;
+        ch.build(csr);
+        ChSearch search;
+        DijkstraEngine engine;
+        bool same = true;
+        int n = csr.getNumVertices();
+        for (int source = 0; source < n; source += 97) {
+            engine.run(csr, source);
+            for (int target = 0; target < n; target += 31) {
+                int cost = search.run(ch, source, target);
+                same = same && cost == engine.getDistances()[target] &&
+                    (cost == INT_MAX ||
+                        isPathOfCost(csr, search.getPath(), source, target,
+                            cost));
+            }
+        }
+        cout << isOK(same, true) << "CH matches Dijkstra, " << n
+            << " vertices, " << ch.getNumShortcuts() << " shortcuts" << endl;
+    }
+}
+
+void testDeltaStepping() {
+    cout << "testDeltaStepping" << endl;
+    Graph g;
+    g.readFile("graph2.txt");
+    g.deltaSteppingCostToAllVertices("O", weight, previous, 2);
+    graphCostDisplay();
+    cout << isOK(graphOut.str(),
+        "P(5) Q(2) R(3) via [Q] S(6) via [Q R] " +
+        "T(8) via [Q R S] U(9) via [Q R S] "s)
+        << "delta-stepping O" << endl;
+
+    // same costs as Dijkstra, same predecessors for any thread count
+    CsrGraph csr = randomCsrGraph(5000, 4, 30, 3);
+    DijkstraEngine engine;
+    engine.run(csr, 0);
+    ThreadPool one(1), four(4);
+    DeltaStepping sequential(one, 5), parallel(four);
+    sequential.run(csr, 0);
+    parallel.run(csr, 0);
+    cout << isOK(sequential.getDistances() == engine.getDistances(), true)
+        << "costs match Dijkstra" << endl;
+    cout << isOK(parallel.getDistances() == engine.getDistances(), true)
+        << "parallel costs match Dijkstra" << endl;
+    cout << isOK(parallel.getPredecessors() == sequential.getPredecessors(),
+        true) << "predecessors independent of threads" << endl;
+
+    // one bucket per unit of cost would not fit in memory
+    Graph far;
+    far.add("A", "B", 2000000000);
+    far.deltaSteppingCostToAllVertices("A", weight, previous, 1);
+    cout << isOK(weight["B"], 2000000000) << "tiny delta, huge weight"
+        << endl;
+    // a sum past INT_MAX is no path, not a wrapped cost
+    Graph heavy;
+    heavy.add("A", "B", INT_MAX - 10);
+    heavy.add("B", "C", 100);
+    heavy.add("A", "C", 5);
+    heavy.deltaSteppingCostToAllVertices("A", weight, previous);
+    cout << isOK(weight["C"], 5) << "no overflow" << endl;
+
+    // a delta that cycles through few buckets many times
+    DeltaStepping narrow(four, 1);
+    narrow.run(csr, 0);
+    cout << isOK(narrow.getDistances() == engine.getDistances(), true)
+        << "delta 1 matches Dijkstra" << endl;
+}
+
+void testCostsFromSources() {
+    cout << "testCostsFromSources" << endl;
+    Graph g;
+    g.readFile("graph2.txt");
+    DistanceMatrix matrix = g.costsFromSources({ "O", "A", "nope" }, true);
+    cout << isOK(matrix.getNumSources(), 3) << "3 rows" << endl;
+    cout << isOK(matrix.cost("O", "U"), 9) << "O to U is 9" << endl;
+    cout << isOK(matrix.cost("O", "O"), 0) << "O to O is 0" << endl;
+    cout << isOK(matrix.cost("A", "O"), INT_MAX) << "A cannot reach O"
+        << endl;
+    cout << isOK(matrix.getSource(2), -1) << "unknown source" << endl;
+    graphOut.str("");
+    for (const string& label : matrix.path("O", "U")) {
+        graphOut << label << " ";
+    }
+    cout << isOK(graphOut.str(), "O Q R S U "s) << "path O to U" << endl;
+
+    // every row matches a single-source run
+    CsrGraph csr = randomCsrGraph(2000, 4, 30, 5);
+    auto shared = std::make_shared<const CsrGraph>(csr);
+    std::vector<int> sources;
+    for (int s = 0; s < 2000; s += 97) sources.push_back(s);
+    DistanceMatrix many(shared, sources, false);
+    ThreadPool four(4);
+    many.compute(four);
+    DijkstraEngine engine;
+    bool same = true;
+    for (int r = 0; r < many.getNumSources(); ++r) {
+        engine.run(csr, sources[r]);
+        same = same && std::equal(engine.getDistances().begin(),
+                                  engine.getDistances().end(), many.row(r));
+    }
+    cout << isOK(same, true) << "rows match Dijkstra" << endl;
+}
+
+void testReadFile() {
+    cout << "testReadFile" << endl;
+    {
+        std::ofstream out("bad.txt");
+        out << "3\nA B 1\nB C x\nC D 1\n";
+    }
+    Graph bad;
+    bad.readFile("bad.txt");
+    cout << isOK(bad.getNumEdges(), 1) << "stops at bad weight" << endl;
+    remove("bad.txt");
+
+    // large enough to be parsed in parallel chunks
+    std::mt19937 random(7);
+    Graph expected;
+    {
+        std::ofstream out("big.txt");
+        out << 120000 << "\n";
+        char line[64];
+        for (int i = 0; i < 120000; ++i) {
+            int from = random() % 20000, to = random() % 20000;
+            int cost = static_cast<int>(random() % 100) - 10;
+            snprintf(line, sizeof(line), "v%05d\tv%05d  %d\r\n", from, to,
+                     cost);
+            out << line;
+        }
+    }
+    Graph big;
+    big.readFile("big.txt");
+    std::ifstream in("big.txt");
+    int header;
+    string start, end;
+    int cost;
+    in >> header;
+    while (in >> start >> end >> cost) expected.add(start, end, cost);
+    in.close();
+    remove("big.txt");
+    cout << isOK(big.getNumEdges(), expected.getNumEdges())
+        << "parallel load edge count" << endl;
+    cout << isOK(big.freeze().fingerprint(), expected.freeze().fingerprint())
+        << "parallel load matches >>" << endl;
+}
+
+void testBinarySnapshot() {
+    cout << "testBinarySnapshot" << endl;
+    Graph g;
+    g.readFile("graph2.txt");
+    cout << isOK(g.saveBinary("graph2.csr"), true) << "save" << endl;
+
+    CsrGraph mapped;
+    cout << isOK(mapped.loadBinary("graph2.csr"), true) << "map" << endl;
+    cout << isOK(mapped.fingerprint(), g.freeze().fingerprint())
+        << "mapped graph is the same" << endl;
+    cout << isOK(mapped.findVertex("U"), g.freeze().findVertex("U"))
+        << "mapped label lookup" << endl;
+
+    Graph loaded;
+    loaded.add("X", "Y", 1);
+    cout << isOK(loaded.loadBinary("graph2.csr"), true) << "load" << endl;
+    cout << isOK(loaded.getNumEdges(), 24) << "24 edges" << endl;
+    cout << isOK(loaded.getEdgeWeight("X", "Y"), INT_MAX)
+        << "old edges are gone" << endl;
+    cout << isOK(pathString(loaded.shortestPath("O", "U")),
+        "9: O Q R S U"s) << "path on loaded graph" << endl;
+    loaded.add("O", "U", 1);
+    cout << isOK(pathString(loaded.shortestPath("O", "U")), "1: O U"s)
+        << "loaded graph can change" << endl;
+
+    // a file in another vertex order is renumbered to the graph's
+    Graph byDegree;
+    byDegree.setVertexOrder(VertexOrder::Degree);
+    byDegree.readFile("graph2.txt");
+    byDegree.saveBinary("graph2degree.csr");
+    Graph byLabel;
+    byLabel.loadBinary("graph2degree.csr");
+    cout << isOK(byLabel.getSnapshot()->fingerprint(),
+                 g.freeze().fingerprint()) << "label order after load" << endl;
+    byLabel.add("O", "U", 1);
+    byLabel.remove("O", "U");
+    cout << isOK(byLabel.getSnapshot()->fingerprint(),
+                 g.freeze().fingerprint()) << "same ids after a change"
+        << endl;
+    Graph degreeAgain;
+    degreeAgain.setVertexOrder(VertexOrder::Degree);
+    degreeAgain.loadBinary("graph2.csr");
+    cout << isOK(degreeAgain.getSnapshot()->fingerprint(),
+                 byDegree.getSnapshot()->fingerprint())
+        << "degree order after load" << endl;
+    remove("graph2degree.csr");
+
+    // flip one byte of the edge arrays
+    {
+        std::fstream file("graph2.csr",
+                          std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(0, std::ios::end);
+        file.seekp(static_cast<std::streamoff>(file.tellg()) - 20);
+        file.put('\x7f');
+    }
+    CsrGraph damaged;
+    cout << isOK(damaged.loadBinary("graph2.csr"), false)
+        << "damaged file rejected" << endl;
+    cout << isOK(damaged.loadBinary("graph2.csr", false), false)
+        << "bad ids rejected without the checksum" << endl;
+    cout << isOK(damaged.getNumVertices(), 0) << "left unchanged" << endl;
+    remove("graph2.csr");
+}
+
+void testAddEdges() {
+    cout << "testAddEdges" << endl;
+    Graph g;
+    g.add("B", "C", 7);
+    std::vector<EdgeRecord> batch = {
+        { "C", "A", 3 }, { "A", "B", 1 }, { "A", "A", 5 }, { "B", "C", 2 },
+        { "A", "B", 9 }, { "A", "C", 4 }, { "D", "B", 6 } };
+    cout << isOK(g.addEdges(batch), 4) << "4 new edges" << endl;
+    cout << isOK(g.getNumEdges(), 5) << "5 edges" << endl;
+    cout << isOK(g.getNumVertices(), 4) << "4 vertices" << endl;
+    cout << isOK(g.getEdgeWeight("A", "B"), 1) << "first record kept"
+        << endl;
+    cout << isOK(g.getEdgeWeight("B", "C"), 7) << "existing edge kept"
+        << endl;
+
+    // same graph as one add per record
+    CsrGraph csr = randomCsrGraph(3000, 3, 50, 11);
+    std::vector<EdgeRecord> records;
+    Graph oneByOne;
+    for (int v = 0; v < csr.getNumVertices(); ++v) {
+        for (int e = csr.edgeBegin(v); e < csr.edgeEnd(v); ++e) {
+            records.push_back({ csr.getLabel(v),
+                csr.getLabel(csr.edgeTarget(e)), csr.edgeWeight(e) });
+        }
+    }
+    std::shuffle(records.begin(), records.end(), std::mt19937(2));
+    records.push_back(records.front());
+    records.back().weight += 1;
+    for (const EdgeRecord& record : records) {
+        oneByOne.add(record.start, record.end, record.weight);
+    }
+    Graph bulk;
+    bulk.add(records[5].start, records[5].end, records[5].weight);
+    bulk.addEdges(records.data(), records.size() / 2);
+    bulk.addEdges(records.data() + records.size() / 2,
+                  records.size() - records.size() / 2);
+    cout << isOK(bulk.freeze().fingerprint(),
+                 oneByOne.freeze().fingerprint())
+        << "same as add" << endl;
+}
+
+void testNodePool() {
+    cout << "testNodePool" << endl;
+    NodePool pool;
+    void* first = pool.allocate(40);
+    void* second = pool.allocate(37);
+    cout << isOK(pool.getBytesInUse(), static_cast<size_t>(80))
+        << "sizes round to 8" << endl;
+    pool.deallocate(first, 40);
+    cout << isOK(pool.allocate(33) == first, true) << "freed node reused"
+        << endl;
+    pool.deallocate(second, 37);
+    cout << isOK(pool.getBytesInUse(), static_cast<size_t>(40))
+        << "bytes in use" << endl;
+
+    // a vertex works without a pool too
+    Vertex v("A");
+    v.connect("B", 1);
+    const Edge& edge = *v.neighbors().begin();
+    cout << isOK(edge.getEndVertex(), "B"s) << "edge label is its key"
+        << endl;
+}
+
+void testVisitorTraversal() {
+    cout << "testVisitorTraversal" << endl;
+    Graph g;
+    g.readFile("graph2.txt");
+    string order;
+    g.depthFirstTraversal("A", [&order](const string& label) {
+        order += label + " ";
+    });
+    cout << isOK(order, "A B E F J C G K L D H M I N "s)
+        << "lambda DFS from A" << endl;
+
+    order.clear();
+    bool stopped = g.breadthFirstTraversal("A", [&order](const string& label) {
+        order += label + " ";
+        return label == "C" ? VisitResult::Stop : VisitResult::Continue;
+    });
+    cout << isOK(order, "A B C "s) << "BFS stops at C" << endl;
+    cout << isOK(stopped, true) << "stop reported" << endl;
+
+    cout << isOK(g.isReachable("O", "U"), true) << "O reaches U" << endl;
+    cout << isOK(g.isReachable("A", "O"), false) << "A cannot reach O"
+        << endl;
+    cout << isOK(g.isReachable("A", "nope"), false) << "unknown end" << endl;
+
+    // deep enough to overflow a recursive DFS
+    Graph chain;
+    std::vector<EdgeRecord> links;
+    for (int i = 0; i < 300000; ++i) {
+        links.push_back({ "c" + std::to_string(i),
+                          "c" + std::to_string(i + 1), 1 });
+    }
+    chain.addEdges(links);
+    int count = 0;
+    chain.depthFirstTraversal("c0", [&count](const string&) { ++count; });
+    cout << isOK(count, 300001) << "DFS over a long chain" << endl;
+}
+
+void testParallelBfs() {
+    cout << "testParallelBfs" << endl;
+    Graph g;
+    g.readFile("graph2.txt");
+    graphOut.str("");
+    g.parallelBreadthFirstTraversal("A", graphVisitor);
+    cout << isOK(graphOut.str(), "A B C D E F G H I J K L M N "s)
+        << "parallel BFS from A" << endl;
+    std::map<string, int> hops;
+    std::map<string, string> parent;
+    g.hopCountToAllVertices("O", hops, parent);
+    cout << isOK(hops["U"], 4) << "O to U is 4 hops" << endl;
+    cout << isOK(parent["R"], "P"s) << "R reached from P" << endl;
+
+    // dense enough for bottom-up steps, compared with a plain BFS
+    CsrGraph csr = randomCsrGraph(9000, 16, 10, 9);
+    int n = csr.getNumVertices();
+    std::vector<int> depth(n, -1), order;
+    depth[0] = 0;
+    order.push_back(0);
+    for (size_t head = 0; head < order.size(); ++head) {
+        int v = order[head];
+        for (int e = csr.edgeBegin(v); e < csr.edgeEnd(v); ++e) {
+            int u = csr.edgeTarget(e);
+            if (depth[u] < 0) {
+                depth[u] = depth[v] + 1;
+                order.push_back(u);
+            }
+        }
+    }
+    ThreadPool one(1), four(4);
+    ParallelBfs serial(one), parallel(four);
+    serial.run(csr, 0);
+    parallel.run(csr, 0);
+    cout << isOK(parallel.getDepths() == depth, true) << "depths" << endl;
+    cout << isOK(parallel.getBottomUpSteps() > 0, true) << "went bottom-up"
+        << endl;
+    cout << isOK(parallel.getParents() == serial.getParents(), true)
+        << "parents independent of threads" << endl;
+    bool parentsOk = true;
+    for (int v = 1; v < n; ++v) {
+        int p = parallel.getParents()[v];
+        parentsOk = parentsOk && (depth[v] < 0 ||
+            depth[p] == depth[v] - 1);
+    }
+    cout << isOK(parentsOk, true) << "parents one hop closer" << endl;
+    parallel.run(csr, 0, true);
+    cout << isOK(parallel.getOrder() == order, true) << "ordered visit"
+        << endl;
+}
+
+void testDynamicSssp() {
+    cout << "testDynamicSssp" << endl;
+    Graph g;
+    g.readFile("graph2.txt");
+    cout << isOK(g.trackSource("O"), true) << "track O" << endl;
+    cout << isOK(g.trackSource("none"), false) << "cannot track none"
+        << endl;
+    cout << isOK(g.trackedCost("O", "U"), 9) << "O to U costs 9" << endl;
+    g.remove("Q", "R");
+    cout << isOK(g.trackedCost("O", "U"), 13) << "without Q R" << endl;
+    g.setEdgeWeight("O", "P", 1);
+    cout << isOK(g.trackedCost("O", "U"), 9) << "cheaper O P" << endl;
+    std::vector<string> path = g.trackedPath("O", "U");
+    std::vector<string> expected = { "O", "P", "R", "S", "U" };
+    cout << isOK(path == expected, true) << "path O P R S U" << endl;
+    g.add("O", "V", 1);
+    cout << isOK(g.trackedCost("O", "V"), 1) << "new vertex V" << endl;
+    g.addEdges(std::vector<EdgeRecord>{ { "V", "W", 2 }, { "W", "U", 1 } });
+    cout << isOK(g.trackedCost("O", "U"), 4) << "batch of edges" << endl;
+    g.untrackSource("O");
+    cout << isOK(g.trackedCost("O", "U"), INT_MAX) << "untracked" << endl;
+
+    // INT_MAX is a weight like any other, not a missing edge
+    Graph heavy;
+    heavy.add("a", "b", INT_MAX);
+    heavy.trackSource("a");
+    cout << isOK(heavy.setEdgeWeight("a", "b", 5), true)
+        << "reweight an INT_MAX edge" << endl;
+    cout << isOK(heavy.getSnapshot()->edgeWeight(0), 5) << "snapshot rebuilt"
+        << endl;
+    cout << isOK(heavy.trackedCost("a", "b"), 5) << "tracked cost follows"
+        << endl;
+    heavy.setEdgeWeight("a", "b", INT_MAX);
+    heavy.setEdgeWeight("a", "b", 7);
+    cout << isOK(heavy.trackedCost("a", "b"), 7) << "edge kept at INT_MAX"
+        << endl;
+
+    // negative weights stop tracking instead of repairing forever
+    Graph cycle;
+    cycle.add("A", "B", 1);
+    cycle.add("B", "C", -5);
+    cycle.add("C", "A", 1);
+    cout << isOK(cycle.trackSource("A"), false) << "negative weight, no track"
+        << endl;
+    cycle.setEdgeWeight("B", "C", 5);
+    cout << isOK(cycle.trackSource("A"), true) << "track without them"
+        << endl;
+    cycle.setEdgeWeight("B", "C", -5);
+    cout << isOK(cycle.trackedCost("A", "C"), INT_MAX)
+        << "negative weight untracks" << endl;
+
+    // random changes, compared with a search from scratch after each
+    std::mt19937 random(11);
+    Graph h;
+    auto label = [&random]() {
+        return string(1, static_cast<char>('A' + random() % 26));
+    };
+    h.add("A", "B", 1);
+    h.trackSource("A");
+    bool same = true;
+    for (int step = 0; step < 400 && same; ++step) {
+        string start = label(), end = label();
+        int change = random() % 3;
+        if (change == 0) {
+            h.add(start, end, random() % 10);
+        } else if (change == 1) {
+            h.remove(start, end);
+        } else {
+            h.setEdgeWeight(start, end, random() % 10);
+        }
+        h.djikstraCostToAllVertices("A", weight, previous);
+        for (char c = 'B'; c <= 'Z'; ++c) {
+            string v(1, c);
+            int cost = weight.count(v) > 0 ? weight[v] : INT_MAX;
+            same = same && h.trackedCost("A", v) == cost;
+        }
+    }
+    cout << isOK(same, true) << "same as a full search" << endl;
+
+    // a dearer edge outside the tree repairs nothing
+    IdAdjacency chain;
+    for (int v = 0; v < 1000; ++v) {
+        chain.addVertex();
+        if (v > 0) chain.addEdge(v - 1, v, 1);
+    }
+    chain.addEdge(0, 999, 5000);
+    DynamicSssp tree(chain, 0);
+    chain.setEdge(0, 999, 6000);
+    tree.edgeRaised(0, 999);
+    cout << isOK(tree.getLastUpdateSize(), 0) << "non-tree edge" << endl;
+    chain.removeEdge(499, 500);
+    tree.edgeRaised(499, 500);
+    cout << isOK(tree.getDistance(999), 6000) << "cut the chain" << endl;
+}
+
+void testVersionedGraph() {
+    cout << "testVersionedGraph" << endl;
+    Graph g;
+    g.readFile("graph1.txt");
+    VersionedGraph versioned(g.freeze());
+    std::shared_ptr<const GraphVersion> first = versioned.snapshot();
+    graphOut.str("");
+    first->breadthFirstTraversal("A", graphVisitor);
+    string plain = graphOut.str();
+    graphOut.str("");
+    g.breadthFirstTraversal("A", graphVisitor);
+    cout << isOK(plain, graphOut.str()) << "same BFS as Graph" << endl;
+    first->djikstraCostToAllVertices("A", weight, previous);
+    map<string, int> expected = weight;
+    g.djikstraCostToAllVertices("A", weight, previous);
+    cout << isOK(expected == weight, true) << "same costs as Graph" << endl;
+
+    cout << isOK(versioned.add("A", "Z", 7), true) << "add A Z" << endl;
+    cout << isOK(versioned.add("A", "Z", 7), false) << "no second A Z"
+        << endl;
+    cout << isOK(first->findVertex("Z"), -1) << "old version unchanged"
+        << endl;
+    std::shared_ptr<const GraphVersion> second = versioned.snapshot();
+    cout << isOK(second->getEdgeWeight("A", "Z"), 7) << "new version"
+        << endl;
+    cout << isOK(second->getVersion(), static_cast<std::uint64_t>(1))
+        << "version 1" << endl;
+    versioned.setEdgeWeight("A", "Z", 3);
+    versioned.remove("A", "B");
+    cout << isOK(second->getEdgeWeight("A", "Z"), 7) << "held weight"
+        << endl;
+    cout << isOK(versioned.snapshot()->getEdgeWeight("A", "B"), INT_MAX)
+        << "A B removed" << endl;
+
+    // an INT_MAX weight is still an edge
+    VersionedGraph heavy;
+    heavy.add("A", "B", INT_MAX);
+    cout << isOK(heavy.add("A", "B", 5), false) << "no second INT_MAX edge"
+        << endl;
+    cout << isOK(heavy.addEdges({ { "A", "B", 5 } }), 0)
+        << "not in a batch either" << endl;
+    cout << isOK(heavy.setEdgeWeight("A", "B", 5), true)
+        << "reweight an INT_MAX edge" << endl;
+    cout << isOK(heavy.snapshot()->getEdgeWeight("A", "B"), 5)
+        << "weight 5" << endl;
+
+    // readers check every version they see while a writer adds edges
+    VersionedGraph shared;
+    bool done = false;
+    std::mutex doneMutex;
+    auto isDone = [&]() {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        return done;
+    };
+    std::vector<int> badVersions(3, 0);
+    std::vector<std::thread> readers;
+    for (int r = 0; r < 3; ++r) {
+        readers.emplace_back([&, r]() {
+            std::uint64_t last = 0;
+            while (!isDone()) {
+                auto version = shared.snapshot();
+                int edges = 0;
+                for (int v = 0; v < version->getNumVertices(); ++v) {
+                    edges += static_cast<int>(version->outArcs(v).size());
+                }
+                // one edge per version, never going back
+                if (edges != version->getNumEdges() ||
+                    static_cast<std::uint64_t>(edges) !=
+                        version->getVersion() ||
+                    version->getVersion() < last) {
+                    badVersions[r]++;
+                }
+                last = version->getVersion();
+            }
+        });
+    }
+    for (int e = 0; e < 3000; ++e) {
+        shared.add(std::to_string(e % 300), std::to_string(e * 11 % 301 + 300),
+                   e);
+    }
+    {
+        std::lock_guard<std::mutex> lock(doneMutex);
+        done = true;
+    }
+    for (std::thread& reader : readers) {
+        reader.join();
+    }
+    cout << isOK(badVersions == std::vector<int>(3, 0), true)
+        << "readers saw whole versions" << endl;
+    cout << isOK(shared.snapshot()->getNumVertices(), 601) << "601 vertices"
+        << endl;
+}
+
+void testVertexOrder() {
+    cout << "testVertexOrder" << endl;
+    Graph g;
+    g.readFile("graph1.txt");
+    g.djikstraCostToAllVertices("A", weight, previous);
+    map<string, int> expected = weight;
+    CsrGraph byLabel = g.freeze();
+    const VertexOrder orders[] = { VertexOrder::Bfs, VertexOrder::Degree,
+                                   VertexOrder::ReverseCuthillMcKee };
+    for (VertexOrder order : orders) {
+        std::vector<int> ids = computeVertexOrder(byLabel, order);
+        std::vector<int> sorted = ids;
+        std::sort(sorted.begin(), sorted.end());
+        bool permutation = true;
+        for (int v = 0; v < byLabel.getNumVertices(); ++v) {
+            permutation = permutation && sorted[v] == v;
+        }
+        cout << isOK(permutation, true) << "every vertex once" << endl;
+        CsrGraph reordered = byLabel.reorder(order);
+        cout << isOK(reordered.getLabel(reordered.findVertex("E")), "E"s)
+            << "labels found after reorder" << endl;
+        reordered.djikstraCostToAllVertices("A", weight, previous);
+        cout << isOK(weight == expected, true) << "same costs" << endl;
+    }
+    g.setVertexOrder(VertexOrder::ReverseCuthillMcKee);
+    g.djikstraCostToAllVertices("A", weight, previous);
+    cout << isOK(weight == expected, true) << "snapshot in RCM order" << endl;
+
+    // a path with its labels shuffled, RCM puts it back in line
+    std::vector<int> position(500);
+    std::iota(position.begin(), position.end(), 0);
+    std::shuffle(position.begin(), position.end(), std::mt19937(3));
+    Graph path;
+    auto name = [&position](int v) {
+        char label[8];
+        std::snprintf(label, sizeof(label), "%04d", position[v]);
+        return string(label);
+    };
+    for (int v = 0; v + 1 < 500; ++v) {
+        path.add(name(v), name(v + 1), 1);
+    }
+    CsrGraph shuffled = path.freeze();
+    CsrGraph inLine = shuffled.reorder(VertexOrder::ReverseCuthillMcKee);
+    cout << isOK(averageEdgeSpan(inLine), 1.0) << "RCM span 1" << endl;
+    cout << isOK(averageEdgeSpan(shuffled) > 10, true) << "shuffled span"
+        << endl;
+
+    std::string file = "reordered.bin";
+    inLine.saveBinary(file);
+    CsrGraph loaded;
+    cout << isOK(loaded.loadBinary(file), true) << "load reordered" << endl;
+    cout << isOK(loaded.findVertex(name(7)), inLine.findVertex(name(7)))
+        << "label index saved" << endl;
+    std::remove(file.c_str());
+}
+
+// hook that keeps every report
+class RecordingHook : public StatsHook {
+ public:
+    void onQuery(const QueryStats& stats) override {
+        reports.push_back(stats);
+    }
+
+    std::vector<QueryStats> reports;
+};
+
+void testQueryStats() {
+    cout << "testQueryStats" << endl;
+    Graph g;
+    RecordingHook hook;
+    g.setStatsHook(&hook);
+    g.readFile("graph1.txt");
+    g.add("G", "A", 2);
+    TraversalState state;
+    g.breadthFirstTraversal("A", graphVisitor, state);
+    QueryStats dijkstra;
+    g.djikstraCostToAllVertices("A", weight, previous, &dijkstra);
+    QueryStats delta;
+    g.deltaSteppingCostToAllVertices("A", weight, previous, 0, &delta);
+    QueryStats levels;
+    g.parallelBreadthFirstTraversal("A", graphVisitor, &levels);
+    QueryStats path;
+    g.shortestPath("A", "G", &path);
+    if (!kStatsEnabled) {
+        cout << isOK(hook.reports.size(), static_cast<size_t>(0))
+            << "no reports without GRAPH_STATS" << endl;
+        cout << isOK(dijkstra.heapPops, 0LL) << "no counts" << endl;
+        return;
+    }
+    cout << isOK(hook.reports.size(), static_cast<size_t>(7))
+        << "7 reports" << endl;
+    cout << isOK(string(hook.reports[0].operation), "readFile"s)
+        << "readFile reported" << endl;
+    cout << isOK(string(hook.reports[1].operation), "add"s)
+        << "add reported" << endl;
+    const QueryStats& bfs = state.getStats();
+    cout << isOK(bfs.verticesSettled, 8LL) << "BFS visits 8" << endl;
+    cout << isOK(bfs.edgesRelaxed, 9LL) << "BFS looks at 9 edges" << endl;
+    cout << isOK(bfs.mapLookups, 10LL) << "one lookup per edge" << endl;
+    cout << isOK(dijkstra.verticesSettled, 8LL) << "Dijkstra settles 8"
+        << endl;
+    cout << isOK(dijkstra.heapPushes == dijkstra.heapPops &&
+                 dijkstra.stalePops == 0 && dijkstra.peakFrontier > 0, true)
+        << "heap counts" << endl;
+    cout << isOK(hook.reports[3].heapPops, dijkstra.heapPops)
+        << "hook sees the same stats" << endl;
+    cout << isOK(delta.verticesSettled, 8LL) << "delta-stepping reaches 8"
+        << endl;
+    cout << isOK(levels.verticesSettled, 8LL) << "parallel BFS visits 8"
+        << endl;
+    cout << isOK(path.verticesSettled > 0 &&
+                 hook.reports[6].verticesSettled == path.verticesSettled,
+                 true) << "shortestPath settles some" << endl;
+    cout << isOK(string(hook.reports[6].operation), "shortestPath"s)
+        << "shortestPath reported" << endl;
+}
+
+void testComponents() {
+    cout << "testComponents" << endl;
+    Graph g;
+    g.readFile("graph2.txt");
+    cout << isOK(g.sameComponent("A", "N"), true) << "A and N joined"
+        << endl;
+    cout << isOK(g.sameComponent("A", "O"), false) << "A and O apart"
+        << endl;
+    g.buildComponents();
+    std::shared_ptr<const Components> parts = g.getComponents();
+    cout << isOK(parts->getNumWeak(), 2) << "2 weak components" << endl;
+    cout << isOK(parts->getNumStrong(), 16) << "16 strong components"
+        << endl;
+    cout << isOK(g.sameStrongComponent("O", "T"), true) << "O T cycle"
+        << endl;
+    cout << isOK(g.sameStrongComponent("O", "U"), false) << "U apart"
+        << endl;
+    cout << isOK(g.shortestPath("A", "O").cost, INT_MAX) << "no path A O"
+        << endl;
+    const CsrGraph& dag = parts->getCondensation();
+    int o = dag.findVertex("O");
+    int u = dag.findVertex("U");
+    cout << isOK(dag.edgeEnd(o) - dag.edgeBegin(o), 1) << "one edge out"
+        << endl;
+    cout << isOK(dag.edgeTarget(dag.edgeBegin(o)) == u &&
+                 dag.edgeWeight(dag.edgeBegin(o)) == 3, true)
+        << "O's component to U costs 3" << endl;
+
+    // both strong component algorithms agree on random graphs
+    ThreadPool pool(4);
+    for (int degree = 1; degree <= 2; ++degree) {
+        CsrGraph csr = randomCsrGraph(9000, degree, 10, 13);
+        std::vector<int> tarjan = Components::strongComponentsTarjan(csr);
+        cout << isOK(Components::strongComponentsColoring(csr, pool) ==
+                     tarjan, true) << "coloring same as Tarjan" << endl;
+        ThreadPool one(1);
+        cout << isOK(Components::weakComponents(csr, pool) ==
+                     Components::weakComponents(csr, one), true)
+            << "weak components same on 1 and 4 threads" << endl;
+    }
+    g.add("N", "O", 1);
+    cout << isOK(g.getComponents() == nullptr, true) << "dropped by add"
+        << endl;
+    cout << isOK(g.sameComponent("A", "O"), true) << "joined by N O" << endl;
+}
+
+void testSsspResult() {
+    cout << "testSsspResult" << endl;
+    Graph g;
+    g.readFile("graph1.txt");
+    SsspResult result = g.shortestPathsFrom("A");
+    cout << isOK(result.cost("G"), 4) << "cost to G" << endl;
+    cout << isOK(result.cost("X"), INT_MAX) << "X not reached" << endl;
+    cout << isOK(result.cost("Q"), INT_MAX) << "Q not in graph" << endl;
+    cout << isOK(result.getNumReached(), 8) << "8 reached" << endl;
+    SsspResult::PathView ids = result.path("G");
+    cout << isOK(ids.size(), 3) << "3 vertices to G" << endl;
+    cout << isOK(result.label(ids[0]) + result.label(ids[1]) +
+                 result.label(ids[2]), "AHG"s) << "path ids" << endl;
+    cout << isOK(result.path("Y").empty(), true) << "no path to Y" << endl;
+    std::vector<std::string> labels = result.pathLabels("F");
+    cout << isOK(labels.size() == 6 && labels.front() == "A" &&
+                 labels.back() == "F", true) << "path labels to F" << endl;
+
+    // the maps it fills are those of djikstraCostToAllVertices
+    std::map<std::string, int> costs;
+    std::map<std::string, std::string> parents;
+    result.toMaps(costs, parents);
+    g.djikstraCostToAllVertices("A", weight, previous);
+    cout << isOK(costs == weight && parents == previous, true)
+        << "same maps as djikstraCostToAllVertices" << endl;
+    g.add("G", "X", 1);
+    cout << isOK(result.cost("X"), INT_MAX) << "result keeps its snapshot"
+        << endl;
+    cout << isOK(g.shortestPathsFrom("A").cost("X"), 5) << "new result"
+        << endl;
+    cout << isOK(g.shortestPathsFrom("Q").getNumReached(), 0)
+        << "unknown source" << endl;
+}
+
+// graph with every weight w of from -> to changed to w + p[from] - p[to]
+// for random p, costs change the same way and some weights go negative
+CsrGraph shiftedCsrGraph(const CsrGraph& graph, vector<int>& potential) {
+    int n = graph.getNumVertices();
+    mt19937 random(5);
+    potential.clear();
+    vector<string> labels;
+    vector<int> offsets{ 0 }, targets, weights;
+    for (int v = 0; v < n; ++v) {
+        potential.push_back(random() % 40);
+        labels.push_back(graph.getLabel(v));
+    }
+    for (int v = 0; v < n; ++v) {
+        for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+            int to = graph.edgeTarget(e);
+            targets.push_back(to);
+            weights.push_back(graph.edgeWeight(e) + potential[v] -
+                              potential[to]);
+        }
+        offsets.push_back(static_cast<int>(targets.size()));
+    }
+    return CsrGraph(labels, offsets, targets, weights);
+}
+
+void testAllPairsPaths() {
+    cout << "testAllPairsPaths" << endl;
+    Graph g;
+    g.readFile("graph1.txt");
+    for (ApspMethod method : { ApspMethod::FloydWarshall,
+                               ApspMethod::Johnson }) {
+        AllPairsPaths all = g.allPairsCosts(true, method);
+        cout << isOK(all.getMethod() == method, true) << "method" << endl;
+        cout << isOK(all.cost("A", "G"), 4) << "A to G" << endl;
+        cout << isOK(all.cost("B", "A"), INT_MAX) << "no B to A" << endl;
+        cout << isOK(all.cost("X", "X"), 0) << "X to X" << endl;
+        vector<string> path = all.path("A", "G");
+        cout << isOK(path == vector<string>{ "A", "H", "G" }, true)
+            << "path A H G" << endl;
+    }
+
+    ThreadPool pool(4);
+    auto shared = make_shared<const CsrGraph>(randomCsrGraph(300, 3, 50, 3));
+    int n = shared->getNumVertices();
+    AllPairsPaths floyd(shared, true, ApspMethod::FloydWarshall);
+    AllPairsPaths johnson(shared, true, ApspMethod::Johnson);
+    AllPairsPaths costsOnly(shared, false, ApspMethod::FloydWarshall);
+    floyd.compute(pool);
+    johnson.compute(pool);
+    costsOnly.compute(pool);
+    DijkstraEngine engine;
+    bool same = true;
+    bool pathsAddUp = true;
+    for (int from = 0; from < n; ++from) {
+        engine.run(*shared, from);
+        for (int to = 0; to < n; ++to) {
+            int expected = engine.getDistances()[to];
+            same = same && floyd.cost(from, to) == expected &&
+                johnson.cost(from, to) == expected &&
+                costsOnly.cost(from, to) == expected;
+            if (expected == INT_MAX || from % 37 != 0) continue;
+            // follow the next hops of each table, adding up weights
+            for (const AllPairsPaths* all : { &floyd, &johnson }) {
+                int sum = 0;
+                for (int v = from; v != to; v = all->nextHop(v, to)) {
+                    int next = all->nextHop(v, to);
+                    int best = INT_MAX;
+                    for (int e = shared->edgeBegin(v);
+                         e < shared->edgeEnd(v); ++e) {
+                        if (shared->edgeTarget(e) == next) {
+                            best = min(best, shared->edgeWeight(e));
+                        }
+                    }
+                    sum += best;
+                }
+                pathsAddUp = pathsAddUp && sum == expected;
+            }
+        }
+    }
+    cout << isOK(same, true) << "Floyd-Warshall, Johnson, Dijkstra agree"
+        << endl;
+    cout << isOK(pathsAddUp, true) << "next hops follow shortest paths"
+        << endl;
+
+    // negative weights
+    vector<int> potential;
+    auto shifted = make_shared<const CsrGraph>(
+        shiftedCsrGraph(*shared, potential));
+    AllPairsPaths shiftedFloyd(shifted, false, ApspMethod::FloydWarshall);
+    AllPairsPaths shiftedJohnson(shifted, false, ApspMethod::Johnson);
+    cout << isOK(shiftedFloyd.compute(pool) && shiftedJohnson.compute(pool),
+                 true) << "negative weights, no negative cycle" << endl;
+    same = true;
+    for (int from = 0; from < n; ++from) {
+        for (int to = 0; to < n; ++to) {
+            int expected = floyd.cost(from, to);
+            if (expected != INT_MAX) {
+                expected += potential[from] - potential[to];
+            }
+            same = same && shiftedFloyd.cost(from, to) == expected &&
+                shiftedJohnson.cost(from, to) == expected;
+        }
+    }
+    cout << isOK(same, true) << "negative weights shift costs" << endl;
+
+    Graph cycle;
+    cycle.add("A", "B", 1);
+    cycle.add("B", "A", -2);
+    for (ApspMethod method : { ApspMethod::FloydWarshall,
+                               ApspMethod::Johnson }) {
+        AllPairsPaths all(cycle.getSnapshot(), false, method);
+        cout << isOK(all.compute(pool), false) << "negative cycle" << endl;
+        cout << isOK(all.cost("A", "B"), INT_MAX) << "no costs" << endl;
+    }
+
+    // costs around these cycles leave int range long before they stop
+    vector<string> labels;
+    vector<int> offsets{ 0 }, targets;
+    for (int v = 0; v < 300; ++v) {
+        labels.push_back("v" + to_string(1000 + v));
+        for (int to = 0; to < 300; ++to) {
+            if (to != v) targets.push_back(to);
+        }
+        offsets.push_back(static_cast<int>(targets.size()));
+    }
+    auto complete = make_shared<const CsrGraph>(labels, offsets, targets,
+        vector<int>(targets.size(), -100000));
+    for (ApspMethod method : { ApspMethod::FloydWarshall,
+                               ApspMethod::Johnson }) {
+        AllPairsPaths all(complete, true, method);
+        cout << isOK(all.compute(pool), false)
+            << "complete graph of negative cycles" << endl;
+    }
+}
+
+void testSsspCache() {
+    cout << "testSsspCache" << endl;
+    Graph g;
+    g.readFile("graph1.txt");
+    std::shared_ptr<const SsspResult> first = g.cachedShortestPathsFrom("A");
+    std::shared_ptr<const SsspResult> again = g.cachedShortestPathsFrom("A");
+    cout << isOK(first == again, true) << "second query shares the tree"
+        << endl;
+    SsspCacheStats stats = g.getSsspCacheStats();
+    cout << isOK(stats.hits == 1 && stats.misses == 1 && stats.entries == 1,
+                 true) << "one hit, one miss" << endl;
+
+    // X cannot be reached from A, so edges from X leave A's costs alone
+    uint64_t version = g.getVersion();
+    g.add("X", "Z", 1);
+    cout << isOK(g.getVersion() != version, true) << "version raised"
+        << endl;
+    cout << isOK(g.cachedShortestPathsFrom("A") == first, true)
+        << "kept after unrelated edge" << endl;
+    cout << isOK(first->cost("Z"), INT_MAX) << "Z not reached" << endl;
+    g.add("G", "X", 1);
+    std::shared_ptr<const SsspResult> after = g.cachedShortestPathsFrom("A");
+    cout << isOK(after != first && after->cost("Z") == 6, true)
+        << "dropped after edge from G" << endl;
+    g.remove("G", "X");
+    cout << isOK(g.cachedShortestPathsFrom("A")->cost("Z"), INT_MAX)
+        << "dropped after remove" << endl;
+    g.setEdgeWeight("A", "H", 10);
+    cout << isOK(g.cachedShortestPathsFrom("A")->cost("G"), 6)
+        << "dropped after setEdgeWeight" << endl;
+    cout << isOK(g.getSsspCacheStats().invalidations, 3LL)
+        << "3 invalidations" << endl;
+
+    // a batch raises the version for every tree
+    g.cachedShortestPathsFrom("A");
+    g.addEdges({ { "Y", "W", 1 } });
+    stats = g.getSsspCacheStats();
+    g.cachedShortestPathsFrom("A");
+    cout << isOK(g.getSsspCacheStats().misses, stats.misses + 1)
+        << "stale after addEdges" << endl;
+    g.cachedShortestPathsFrom("Q");
+    cout << isOK(g.getSsspCacheStats().entries, size_t(1))
+        << "unknown source not kept" << endl;
+
+    // room for one tree: the least recently used one goes
+    g.setSsspCacheLimit(g.getSsspCacheStats().bytes);
+    g.cachedShortestPathsFrom("X");
+    stats = g.getSsspCacheStats();
+    cout << isOK(stats.entries == 1 && stats.evictions == 1, true)
+        << "A evicted for X" << endl;
+    g.cachedShortestPathsFrom("A");
+    cout << isOK(g.getSsspCacheStats().misses, stats.misses + 1)
+        << "A computed again" << endl;
+    g.setSsspCacheLimit(0);
+    cout << isOK(g.getSsspCacheStats().entries, size_t(0))
+        << "limit 0 empties the cache" << endl;
+    cout << isOK(g.cachedShortestPathsFrom("A")->cost("G"), 6)
+        << "still answers" << endl;
+
+    // threads rebuilding paths on one shared result
+    std::shared_ptr<const SsspResult> shared = g.cachedShortestPathsFrom("A");
+    vector<string> expected = shared->pathLabels("G");
+    vector<char> same(4, 1);
+    vector<thread> readers;
+    for (int t = 0; t < 4; ++t) {
+        readers.emplace_back([&shared, &expected, &same, t]() {
+            for (int i = 0; i < 2000; ++i) {
+                SsspResult::PathView ids = shared->path("G");
+                same[t] = same[t] && shared->pathLabels("G") == expected &&
+                    ids.size() == static_cast<int>(expected.size()) &&
+                    shared->label(ids[ids.size() - 1]) == "G";
+            }
+        });
+    }
+    for (thread& reader : readers) {
+        reader.join();
+    }
+    cout << isOK(count(same.begin(), same.end(), 1), 4L)
+        << "paths from 4 threads" << endl;
+}
+
+void testVertexNeighbors() {
+    cout << "testVertexNeighbors" << endl;
+    Vertex v("A");
+    v.connect("C", 3);
+    v.connect("B", 2);
+    v.connect("D", 4);
+    v.disconnect("C");
+
+    graphOut.str("");
+    for (const Edge& edge : v.neighbors()) {
+        graphOut << edge.getEndVertex() << edge.getWeight() << " ";
+    }
+    cout << isOK(graphOut.str(), "B2 D4 "s) << "neighbors" << endl;
+
+    graphOut.str("");
+    for (string s = v.getNextNeighbor(); s != "A"; s = v.getNextNeighbor()) {
+        graphOut << s << " ";
+    }
+    cout << isOK(graphOut.str(), "B D "s) << "getNextNeighbor" << endl;
+}
+
+void testCsrGraph() {
+    cout << "testCsrGraph" << endl;
+    Graph g;
+    g.readFile("graph2.txt");
+    CsrGraph csr = g.freeze();
+    cout << isOK(csr.getNumVertices(), 21) << "21 vertices" << endl;
+    cout << isOK(csr.getNumEdges(), 24) << "24 edges" << endl;
+
+    graphOut.str("");
+    csr.depthFirstTraversal("A", graphVisitor);
+    cout << isOK(graphOut.str(), "A B E F J C G K L D H M I N "s)
+        << "CSR DFS from A" << endl;
+
+    graphOut.str("");
+    csr.breadthFirstTraversal("A", graphVisitor);
+    cout << isOK(graphOut.str(), "A B C D E F G H I J K L M N "s)
+        << "CSR BFS from A" << endl;
+
+    csr.djikstraCostToAllVertices("O", weight, previous);
+    graphCostDisplay();
+    cout << isOK(graphOut.str(),
+        "P(5) Q(2) R(3) via [Q] S(6) via [Q R] " +
+        "T(8) via [Q R S] U(9) via [Q R S] "s)
+        << "CSR Djisktra O" << endl;
+}
+
+void testDijkstraEngine() {
+    cout << "testDijkstraEngine" << endl;
+    CsrGraph csr = randomCsrGraph(2000, 4, 100, 42);
+    DijkstraEngine reference(HeapType::Binary);
+    reference.run(csr, 0);
+    for (HeapType type : { HeapType::FourAry, HeapType::Pairing,
+        HeapType::Radix }) {
+        DijkstraEngine engine(type);
+        // run twice to check that reused buffers are cleaned up
+        engine.run(csr, 1);
+        engine.run(csr, 0);
+        cout << isOK(engine.getDistances() == reference.getDistances(), true)
+            << "heap " << static_cast<int>(type) << " distances" << endl;
+    }
+
+    // predecessors must lead back to the source along real edges
+    const vector<int>& dist = reference.getDistances();
+    const vector<int>& pred = reference.getPredecessors();
+    bool consistent = true;
+    for (int v = 1; v < csr.getNumVertices(); ++v) {
+        if (dist[v] == INT_MAX) continue;
+        int u = pred[v];
+        bool found = false;
+        for (int e = csr.edgeBegin(u); e < csr.edgeEnd(u); ++e) {
+            if (csr.edgeTarget(e) == v &&
+                dist[u] + csr.edgeWeight(e) == dist[v]) found = true;
+        }
+        consistent = consistent && found;
+    }
+    cout << isOK(consistent, true) << "predecessor tree" << endl;
+
+    // a negative cycle gives no costs instead of running forever
+    Graph cycle;
+    cycle.add("A", "B", 1);
+    cycle.add("B", "C", -5);
+    cycle.add("C", "A", 1);
+    cycle.djikstraCostToAllVertices("A", weight, previous);
+    cout << isOK(weight.empty(), true) << "negative cycle, no costs" << endl;
+    cout << isOK(cycle.shortestPath("A", "C").cost, INT_MAX)
+        << "negative cycle, no path" << endl;
+    cycle.deltaSteppingCostToAllVertices("A", weight, previous);
+    cout << isOK(weight.empty(), true) << "negative cycle, delta-stepping"
+        << endl;
+    cycle.remove("C", "A");
+    cycle.djikstraCostToAllVertices("A", weight, previous);
+    cout << isOK(weight["C"], -4) << "negative edge, no cycle" << endl;
+
+    // a sum past INT_MAX is no path, not a wrapped cost
+    Graph heavy;
+    heavy.add("A", "B", INT_MAX - 10);
+    heavy.add("B", "C", 100);
+    heavy.add("A", "C", 5);
+    heavy.djikstraCostToAllVertices("A", weight, previous);
+    cout << isOK(weight["C"], 5) << "no overflow" << endl;
+}
+
+// true if TypedDijkstra<Weight> on a copy of csr finds the costs
+// DijkstraEngine finds on csr, from a few sources
+template <class Weight>
+bool typedMatchesEngine(const CsrGraph& csr) {
+    TypedCsr<Weight> typed;
+    if (!typed.assign(csr)) return false;
+    DijkstraEngine engine;
+    TypedDijkstra<Weight> search;
+    bool same = true;
+    for (int source = 0; source < 5; ++source) {
+        engine.run(csr, source);
+        search.run(typed, source);
+        for (int v = 0; v < csr.getNumVertices(); ++v) {
+            int cost = engine.getDistances()[v];
+            same = same && (cost == INT_MAX
+                ? search.getDistances()[v] == search.unreachable()
+                : search.getDistances()[v] == cost);
+        }
+    }
+    return same;
+}
+
+void testTypedCsr() {
+    cout << "testTypedCsr" << endl;
+    CsrGraph csr = randomCsrGraph(2000, 4, 100, 42);
+    cout << isOK(typedMatchesEngine<uint16_t>(csr), true) << "uint16_t"
+        << endl;
+    cout << isOK(typedMatchesEngine<uint32_t>(csr), true) << "uint32_t"
+        << endl;
+    cout << isOK(typedMatchesEngine<int64_t>(csr), true) << "int64_t"
+        << endl;
+    cout << isOK(typedMatchesEngine<float>(csr), true) << "float" << endl;
+
+    TypedCsr<uint16_t> small;
+    small.assign(csr);
+    cout << isOK(small.getMemoryBytes(),
+                 size_t(4 * (2001 + 8000) + 2 * 8000))
+        << "6 bytes per edge" << endl;
+
+    // every edge of the same graph costing 1 runs as a BFS
+    vector<string> labels;
+    vector<int> offsets, targets;
+    for (int v = 0; v < csr.getNumVertices(); ++v) {
+        labels.push_back(csr.getLabel(v));
+        offsets.push_back(csr.edgeBegin(v));
+    }
+    offsets.push_back(csr.getNumEdges());
+    for (int e = 0; e < csr.getNumEdges(); ++e) {
+        targets.push_back(csr.edgeTarget(e));
+    }
+    CsrGraph unit(labels, offsets, targets,
+                  vector<int>(csr.getNumEdges(), 1));
+    cout << isOK(typedMatchesEngine<UnitWeight>(unit), true) << "unit"
+        << endl;
+
+    TypedCsr<UnitWeight> hops;
+    cout << isOK(hops.assign(csr), false) << "weights other than 1" << endl;
+    CsrGraph heavy({ "A", "B" }, { 0, 1, 1 }, { 1 }, { 70000 });
+    cout << isOK(small.assign(heavy), false) << "70000 is no uint16_t"
+        << endl;
+    cout << isOK(small.getNumEdges(), 8000) << "left unchanged" << endl;
+    cout << isOK(TypedCsr<uint32_t>::canHold(
+        CsrGraph({ "A", "B" }, { 0, 1, 1 }, { 1 }, { -1 })), false)
+        << "-1 is no uint32_t" << endl;
+    CsrGraph negative({ "A", "B" }, { 0, 1, 1 }, { 1 }, { -1 });
+    cout << isOK(TypedCsr<std::int64_t>::canHold(negative), false)
+        << "-1 refused by int64_t" << endl;
+    TypedCsr<float> fractions;
+    cout << isOK(fractions.assign(negative), false)
+        << "-1 refused by float" << endl;
+}
+
 int main() {
     testGraph0();
     testGraph1();
     testGraph2();
+    testVertexNeighbors();
+    testCsrGraph();
+    testDijkstraEngine();
+    testShortestPath();
+    testLandmarks();
+    testContractionHierarchy();
+    testDeltaStepping();
+    testCostsFromSources();
+    testReadFile();
+    testBinarySnapshot();
+    testAddEdges();
+    testNodePool();
+    testVisitorTraversal();
+    testParallelBfs();
+    testDynamicSssp();
+    testVersionedGraph();
+    testVertexOrder();
+    testQueryStats();
+    testComponents();
+    testSsspResult();
+    testAllPairsPaths();
+    testSsspCache();
+    testTypedCsr();
 
     return 0;
 }
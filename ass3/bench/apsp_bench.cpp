@@ -0,0 +1,72 @@
+// All-pairs shortest paths by blocked Floyd-Warshall and by Johnson on
+// random graphs of growing density, with the throughput of each as
+// GFLOP-equivalents: 2 n^3 min-plus operations, an add and a min for
+// every pair and every middle vertex, over the time taken, which is the
+// work Floyd-Warshall does whatever the density
+// Build with the CMake option ASS3_AVX2 for the vectorized kernel
+//
+// usage: apsp_bench [vertices] [runs]
+// built by the CMake target apsp_bench
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "allpairspaths.h"
+#include "csrgraph.h"
+#include "graphgenerators.h"
+#include "threadpool.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    int numVertices = argc > 1 ? atoi(argv[1]) : 2000;
+    int runs = argc > 2 ? atoi(argv[2]) : 3;
+    ThreadPool pool;
+    double operations = 2.0 * numVertices * numVertices * numVertices;
+#ifdef __AVX2__
+    const char* kernel = "avx2";
+#else
+    const char* kernel = "scalar";
+#endif
+
+    cout << "{" << endl;
+    cout << "  \"vertices\": " << numVertices << ", \"threads\": "
+        << pool.getNumThreads() << ", \"kernel\": \"" << kernel << "\","
+        << endl;
+    cout << "  \"results\": [" << endl;
+    bool first = true;
+    for (int degree = 4; degree < numVertices; degree *= 4) {
+        auto graph = make_shared<const CsrGraph>(
+            randomCsrGraph(numVertices, degree));
+        bool autoFloyd = AllPairsPaths::chooseMethod(*graph) ==
+            ApspMethod::FloydWarshall;
+        for (bool nextHops : { false, true }) {
+            AllPairsPaths floyd(graph, nextHops, ApspMethod::FloydWarshall);
+            AllPairsPaths johnson(graph, nextHops, ApspMethod::Johnson);
+            double floydMs = timeBest(runs, [&] { floyd.compute(pool); });
+            double johnsonMs = timeBest(runs, [&] { johnson.compute(pool); });
+            bool same = true;
+            for (int v = 0; v < numVertices && same; ++v) {
+                same = equal(floyd.row(v), floyd.row(v) + numVertices,
+                             johnson.row(v));
+            }
+            cout << (first ? "" : ",\n") << "    {\"edges_per_vertex\": "
+                << degree << ", \"next_hops\": "
+                << (nextHops ? "true" : "false") << ", \"auto\": \""
+                << (autoFloyd ? "floyd_warshall" : "johnson")
+                << "\", \"floyd_warshall_ms\": " << floydMs
+                << ", \"floyd_warshall_gflops\": "
+                << operations / floydMs / 1e6
+                << ", \"johnson_ms\": " << johnsonMs
+                << ", \"johnson_gflops\": " << operations / johnsonMs / 1e6
+                << ", \"same\": " << (same ? "true" : "false") << "}";
+            first = false;
+        }
+    }
+    cout << endl << "  ]" << endl << "}" << endl;
+    return 0;
+}
@@ -0,0 +1,51 @@
+// Scaling of parallel delta-stepping against the sequential DijkstraEngine
+// on a random graph, for 1, 2, 4, ... threads and for all cores
+//
+// usage: deltastepping_bench [vertices] [edges per vertex] [runs]
+// built by the CMake target deltastepping_bench
+
+#include <cstdlib>
+#include <iostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "csrgraph.h"
+#include "deltastepping.h"
+#include "dijkstraengine.h"
+#include "graphgenerators.h"
+#include "threadpool.h"
+
+using namespace std;
+
+int main(int argc, char* argv[]) {
+    int numVertices = argc > 1 ? atoi(argv[1]) : 1000000;
+    int edgesPerVertex = argc > 2 ? atoi(argv[2]) : 8;
+    int runs = argc > 3 ? atoi(argv[3]) : 3;
+    CsrGraph graph = randomCsrGraph(numVertices, edgesPerVertex);
+
+    DijkstraEngine engine;
+    double sequential = timeBest(runs, [&] { engine.run(graph, 0); });
+    cout << "graph " << numVertices << " vertices "
+        << graph.getNumEdges() << " edges" << endl;
+    cout << "dijkstra        " << sequential << " ms" << endl;
+
+    int cores = static_cast<int>(thread::hardware_concurrency());
+    if (cores < 1) cores = 1;
+    // powers of two, then every core if that is not one of them
+    vector<int> counts;
+    for (int threads = 1; threads < cores; threads *= 2) {
+        counts.push_back(threads);
+    }
+    counts.push_back(cores);
+    for (int threads : counts) {
+        ThreadPool pool(threads);
+        DeltaStepping search(pool);
+        double took = timeBest(runs, [&] { search.run(graph, 0); });
+        bool same = search.getDistances() == engine.getDistances();
+        cout << "delta-stepping  " << threads << " threads " << took
+            << " ms, speedup " << sequential / took
+            << (same ? "" : "  COSTS DIFFER") << endl;
+    }
+    return 0;
+}
@@ -0,0 +1,229 @@
+// Timings of the main Graph operations on a synthetic graph, printed as
+// one JSON object so runs can be compared by scripts:
+// readFile, add, depth-first and breadth-first traversal and Dijkstra
+// into label maps, into SsspResult arrays, through the result cache and
+// on a copy with 16-bit weights,
+// each with its rate in edges per second and latency percentiles, and
+// the peak resident memory of the process
+//
+// usage: graph_bench [rmat|grid|er] [edges] [queries] [seed]
+// edges can be written as 1e6; the edge file for readFile is written to
+// and removed from the working directory
+// built by the CMake target graph_bench
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#include <psapi.h>
+#else
+#include <sys/resource.h>
+#endif
+
+#include "csrgraph.h"
+#include "graph.h"
+#include "graphgenerators.h"
+#include "typedcsr.h"
+
+using namespace std;
+
+typedef chrono::steady_clock Clock;
+
+// one line of the report
+struct Measurement {
+    string name;
+    // latency of each call, in microseconds
+    vector<double> latencies;
+    // edges handled by all calls together
+    double edges;
+};
+
+// peak resident set size of this process, in kilobytes
+long long peakRssKb() {
+#ifdef _WIN32
+    PROCESS_MEMORY_COUNTERS counters;
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters,
+                              sizeof(counters))) {
+        return -1;
+    }
+    return static_cast<long long>(counters.PeakWorkingSetSize / 1024);
+#else
+    struct rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0) return -1;
+#ifdef __APPLE__
+    return usage.ru_maxrss / 1024;
+#else
+    return usage.ru_maxrss;
+#endif
+#endif
+}
+
+// microseconds since start
+double since(Clock::time_point start) {
+    return chrono::duration<double, micro>(Clock::now() - start).count();
+}
+
+// value below which the given fraction of the sorted values fall
+double percentile(const vector<double>& sorted, double fraction) {
+    if (sorted.empty()) return 0;
+    size_t rank = static_cast<size_t>(fraction * (sorted.size() - 1) + 0.5);
+    return sorted[rank];
+}
+
+// edges leaving the vertices that can be reached from source
+double reachableEdges(const CsrGraph& graph, int source) {
+    vector<char> visited(graph.getNumVertices(), 0);
+    vector<int> queue{ source };
+    visited[source] = 1;
+    double edges = 0;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int v = queue[head];
+        edges += graph.edgeEnd(v) - graph.edgeBegin(v);
+        for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+            if (!visited[graph.edgeTarget(e)]) {
+                visited[graph.edgeTarget(e)] = 1;
+                queue.push_back(graph.edgeTarget(e));
+            }
+        }
+    }
+    return edges;
+}
+
+void printMeasurement(const Measurement& measurement, bool last) {
+    vector<double> sorted = measurement.latencies;
+    sort(sorted.begin(), sorted.end());
+    double total = 0;
+    for (double latency : sorted) {
+        total += latency;
+    }
+    cout << "    {\"name\": \"" << measurement.name << "\", \"calls\": "
+        << sorted.size() << ", \"total_ms\": " << total / 1000
+        << ", \"edges_per_sec\": "
+        << (total > 0 ? measurement.edges / (total / 1e6) : 0)
+        << ", \"p50_us\": " << percentile(sorted, 0.5)
+        << ", \"p90_us\": " << percentile(sorted, 0.9)
+        << ", \"p99_us\": " << percentile(sorted, 0.99)
+        << ", \"max_us\": " << (sorted.empty() ? 0 : sorted.back()) << "}"
+        << (last ? "" : ",") << endl;
+}
+
+int main(int argc, char* argv[]) {
+    string generator = argc > 1 ? argv[1] : "rmat";
+    auto numEdges = static_cast<int64_t>(argc > 2 ? atof(argv[2]) : 1e6);
+    int queries = argc > 3 ? atoi(argv[3]) : 20;
+    unsigned seed = argc > 4 ? static_cast<unsigned>(atoi(argv[4])) : 1;
+
+    vector<EdgeRecord> edges;
+    if (!generateGraph(generator, numEdges, seed, edges)) {
+        cerr << "unknown generator " << generator
+            << ", use rmat, grid or er" << endl;
+        return 1;
+    }
+    vector<Measurement> measurements;
+
+    // readFile, on a file written first
+    string filename = "graph_bench_" + generator + ".txt";
+    if (!writeEdgeFile(filename, edges)) {
+        cerr << "cannot write " << filename << endl;
+        return 1;
+    }
+    {
+        Graph g;
+        Clock::time_point start = Clock::now();
+        g.readFile(filename);
+        measurements.push_back({ "readFile", { since(start) },
+                                 static_cast<double>(edges.size()) });
+    }
+    remove(filename.c_str());
+
+    // add, one call at a time, kept for the queries
+    Graph g;
+    Measurement adds{ "add", {}, static_cast<double>(edges.size()) };
+    adds.latencies.reserve(edges.size());
+    for (const EdgeRecord& edge : edges) {
+        Clock::time_point start = Clock::now();
+        g.add(edge.start, edge.end, edge.weight);
+        adds.latencies.push_back(since(start));
+    }
+    measurements.push_back(adds);
+
+    // the same random sources for every query type
+    shared_ptr<const CsrGraph> csr = g.getSnapshot();
+    mt19937 random(seed);
+    vector<string> sources;
+    double edgesPerQuery = 0;
+    for (int q = 0; q < queries && csr->getNumVertices() > 0; ++q) {
+        int source = static_cast<int>(random() % csr->getNumVertices());
+        sources.push_back(csr->getLabel(source));
+        edgesPerQuery += reachableEdges(*csr, source);
+    }
+
+    Measurement dfs{ "depthFirstTraversal", {}, edgesPerQuery };
+    Measurement bfs{ "breadthFirstTraversal", {}, edgesPerQuery };
+    Measurement dijkstra{ "djikstraCostToAllVertices", {}, edgesPerQuery };
+    Measurement arrays{ "shortestPathsFrom", {}, edgesPerQuery };
+    Measurement cached{ "cachedShortestPathsFrom repeated", {},
+                        edgesPerQuery };
+    Measurement narrow{ "TypedDijkstra<uint16_t>", {}, edgesPerQuery };
+    // the generators' weights are 1..100
+    TypedCsr<uint16_t> typed;
+    typed.assign(*csr);
+    TypedDijkstra<uint16_t> typedSearch;
+    long long visited = 0;
+    auto count = [&visited](const string&) { ++visited; };
+    map<string, int> weight;
+    map<string, string> previous;
+    for (const string& source : sources) {
+        Clock::time_point start = Clock::now();
+        g.depthFirstTraversal(source, count);
+        dfs.latencies.push_back(since(start));
+        start = Clock::now();
+        g.breadthFirstTraversal(source, count);
+        bfs.latencies.push_back(since(start));
+        start = Clock::now();
+        g.djikstraCostToAllVertices(source, weight, previous);
+        dijkstra.latencies.push_back(since(start));
+        start = Clock::now();
+        SsspResult result = g.shortestPathsFrom(source);
+        arrays.latencies.push_back(since(start));
+        // the first call fills the cache, the second is timed
+        g.cachedShortestPathsFrom(source);
+        start = Clock::now();
+        g.cachedShortestPathsFrom(source);
+        cached.latencies.push_back(since(start));
+        start = Clock::now();
+        typedSearch.run(typed, csr->findVertex(source));
+        narrow.latencies.push_back(since(start));
+    }
+    measurements.push_back(dfs);
+    measurements.push_back(bfs);
+    measurements.push_back(dijkstra);
+    measurements.push_back(arrays);
+    measurements.push_back(cached);
+    measurements.push_back(narrow);
+
+    cout << "{" << endl;
+    cout << "  \"generator\": \"" << generator << "\", \"seed\": " << seed
+        << ", \"vertices\": " << g.getNumVertices() << ", \"edges\": "
+        << g.getNumEdges() << ", \"queries\": " << sources.size()
+        << ", \"visited\": " << visited << "," << endl;
+    cout << "  \"peak_rss_kb\": " << peakRssKb() << "," << endl;
+    cout << "  \"results\": [" << endl;
+    for (size_t i = 0; i < measurements.size(); ++i) {
+        printMeasurement(measurements[i], i + 1 == measurements.size());
+    }
+    cout << "  ]" << endl;
+    cout << "}" << endl;
+    return 0;
+}
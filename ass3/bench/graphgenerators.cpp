@@ -0,0 +1,155 @@
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+#include "graphgenerators.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/** label of vertex v */
+std::string label(std::int64_t v) { return std::to_string(v); }
+
+/** random weight 1..100 */
+int randomWeight(std::mt19937_64& random) {
+    return 1 + static_cast<int>(random() % 100);
+}
+
+}  // namespace
+
+/** R-MAT (Kronecker) graph with skewed, power-law degrees like social
+    and web graphs, on 2^scale vertices for the smallest scale giving
+    at least numEdges / 16 vertices, quadrant odds .57 .19 .19 .05 */
+std::vector<EdgeRecord> rmatGraph(std::int64_t numEdges, unsigned seed) {
+    int scale = 1;
+    while ((std::int64_t(1) << scale) * 16 < numEdges) {
+        ++scale;
+    }
+    std::mt19937_64 random(seed);
+    std::uniform_real_distribution<double> odds(0, 1);
+    std::vector<EdgeRecord> edges;
+    edges.reserve(numEdges);
+    for (std::int64_t e = 0; e < numEdges; ++e) {
+        std::int64_t from = 0;
+        std::int64_t to = 0;
+        for (int bit = 0; bit < scale; ++bit) {
+            double pick = odds(random);
+            from = from * 2 + (pick >= 0.76 ? 1 : 0);
+            to = to * 2 + ((pick >= 0.57 && pick < 0.76) || pick >= 0.95
+                           ? 1 : 0);
+        }
+        edges.push_back({ label(from), label(to), randomWeight(random) });
+    }
+    return edges;
+}
+
+/** road-like square grid, each vertex joined both ways to its right
+    and lower neighbors, about numEdges / 4 vertices */
+std::vector<EdgeRecord> gridGraph(std::int64_t numEdges, unsigned seed) {
+    std::int64_t side =
+        static_cast<std::int64_t>(std::sqrt(numEdges / 4.0)) + 1;
+    std::mt19937_64 random(seed);
+    std::vector<EdgeRecord> edges;
+    edges.reserve(numEdges);
+    for (std::int64_t v = 0; static_cast<std::int64_t>(edges.size()) <
+         numEdges; ++v) {
+        std::int64_t neighbors[] = { v % side + 1 < side ? v + 1 : -1,
+                                     v + side };
+        for (std::int64_t u : neighbors) {
+            if (u < 0) continue;
+            int weight = randomWeight(random);
+            edges.push_back({ label(v), label(u), weight });
+            edges.push_back({ label(u), label(v), weight });
+        }
+    }
+    edges.resize(numEdges);
+    return edges;
+}
+
+/** Erdos-Renyi graph, numEdges / 8 vertices and edges between
+    uniformly random pairs */
+std::vector<EdgeRecord> erdosRenyiGraph(std::int64_t numEdges,
+                                        unsigned seed) {
+    std::int64_t numVertices = numEdges / 8 > 2 ? numEdges / 8 : 2;
+    std::mt19937_64 random(seed);
+    std::vector<EdgeRecord> edges;
+    edges.reserve(numEdges);
+    while (static_cast<std::int64_t>(edges.size()) < numEdges) {
+        std::int64_t from = random() % numVertices;
+        std::int64_t to = random() % numVertices;
+        if (from == to) continue;
+        edges.push_back({ label(from), label(to), randomWeight(random) });
+    }
+    return edges;
+}
+
+/** generator by name: "rmat", "grid" or "er"
+    returns false if the name is unknown */
+bool generateGraph(const std::string& name, std::int64_t numEdges,
+                   unsigned seed, std::vector<EdgeRecord>& edges) {
+    if (name == "rmat") {
+        edges = rmatGraph(numEdges, seed);
+    } else if (name == "grid") {
+        edges = gridGraph(numEdges, seed);
+    } else if (name == "er") {
+        edges = erdosRenyiGraph(numEdges, seed);
+    } else {
+        return false;
+    }
+    return true;
+}
+
+/** write edges in the format read by Graph::readFile
+    return false if the file could not be written */
+bool writeEdgeFile(const std::string& filename,
+                   const std::vector<EdgeRecord>& edges) {
+    std::FILE* file = std::fopen(filename.c_str(), "w");
+    if (file == nullptr) return false;
+    std::fprintf(file, "%zu\n", edges.size());
+    for (const EdgeRecord& edge : edges) {
+        std::fprintf(file, "%s %s %d\n", edge.start.c_str(),
+                     edge.end.c_str(), edge.weight);
+    }
+    return std::fclose(file) == 0;
+}
+
+/** CsrGraph in which vertex v has the outgoing edges rows[v], as
+    pairs of target id and weight, and its id zero-padded to 10 digits
+    as label, so label order is id order; rows are sorted by target */
+CsrGraph csrFromRows(std::vector<std::vector<std::pair<int, int>>> rows) {
+    std::vector<std::string> labels;
+    std::vector<int> offsets{ 0 };
+    std::vector<int> targets;
+    std::vector<int> weights;
+    for (size_t v = 0; v < rows.size(); ++v) {
+        std::string digits = std::to_string(v);
+        labels.push_back(std::string(10 - digits.size(), '0') + digits);
+        std::sort(rows[v].begin(), rows[v].end());
+        for (const auto& edge : rows[v]) {
+            targets.push_back(edge.first);
+            weights.push_back(edge.second);
+        }
+        offsets.push_back(static_cast<int>(targets.size()));
+    }
+    return CsrGraph(std::move(labels), std::move(offsets),
+                    std::move(targets), std::move(weights));
+}
+
+/** uniform random CsrGraph, edgesPerVertex edges leave each vertex,
+    weights 1..100 */
+CsrGraph randomCsrGraph(int numVertices, int edgesPerVertex,
+                        unsigned seed) {
+    std::mt19937 random(seed);
+    std::vector<std::vector<std::pair<int, int>>> rows(numVertices);
+    for (int v = 0; v < numVertices; ++v) {
+        for (int e = 0; e < edgesPerVertex; ++e) {
+            int target = static_cast<int>(random() % numVertices);
+            rows[v].push_back({ target, 1 + static_cast<int>(random() % 100) });
+        }
+    }
+    return csrFromRows(std::move(rows));
+}
@@ -0,0 +1,72 @@
+/**
+ * Synthetic graphs for the benchmarks, as edge lists Graph::addEdges
+ * takes and writeEdgeFile saves in the format of Graph::readFile
+ * Vertices are labelled with their number; weights are 1..100
+ * Every generator is deterministic for a given seed and makes exactly
+ * numEdges edge records, which may contain repeated edges and, for
+ * R-MAT, self-loops that Graph drops like any other input
+ * The benchmarks that work on CsrGraph directly build it from rows of
+ * edges with csrFromRows, and time their runs with timeBest
+ */
+
+#ifndef GRAPHGENERATORS_H
+#define GRAPHGENERATORS_H
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "csrgraph.h"
+#include "graph.h"
+
+/** R-MAT (Kronecker) graph with skewed, power-law degrees like social
+    and web graphs, on 2^scale vertices for the smallest scale giving
+    at least numEdges / 16 vertices, quadrant odds .57 .19 .19 .05 */
+std::vector<EdgeRecord> rmatGraph(std::int64_t numEdges, unsigned seed);
+
+/** road-like square grid, each vertex joined both ways to its right
+    and lower neighbors, about numEdges / 4 vertices */
+std::vector<EdgeRecord> gridGraph(std::int64_t numEdges, unsigned seed);
+
+/** Erdos-Renyi graph, numEdges / 8 vertices and edges between
+    uniformly random pairs */
+std::vector<EdgeRecord> erdosRenyiGraph(std::int64_t numEdges,
+                                        unsigned seed);
+
+/** generator by name: "rmat", "grid" or "er"
+    returns false if the name is unknown */
+bool generateGraph(const std::string& name, std::int64_t numEdges,
+                   unsigned seed, std::vector<EdgeRecord>& edges);
+
+/** write edges in the format read by Graph::readFile
+    return false if the file could not be written */
+bool writeEdgeFile(const std::string& filename,
+                   const std::vector<EdgeRecord>& edges);
+
+/** CsrGraph in which vertex v has the outgoing edges rows[v], as
+    pairs of target id and weight, and its id zero-padded to 10 digits
+    as label, so label order is id order; rows are sorted by target */
+CsrGraph csrFromRows(std::vector<std::vector<std::pair<int, int>>> rows);
+
+/** uniform random CsrGraph, edgesPerVertex edges leave each vertex,
+    weights 1..100 */
+CsrGraph randomCsrGraph(int numVertices, int edgesPerVertex,
+                        unsigned seed = 1);
+
+/** best of runs calls of run, in milliseconds */
+template <typename F>
+double timeBest(int runs, F run) {
+    double best = 1e300;
+    for (int r = 0; r < runs; ++r) {
+        auto start = std::chrono::steady_clock::now();
+        run();
+        std::chrono::duration<double, std::milli> took =
+            std::chrono::steady_clock::now() - start;
+        if (took.count() < best) best = took.count();
+    }
+    return best;
+}
+
+#endif  // GRAPHGENERATORS_H
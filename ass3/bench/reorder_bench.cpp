@@ -0,0 +1,98 @@
+// Effect of the vertex order on BFS and Dijkstra over a road-like grid
+// whose labels are shuffled, so label order scatters neighbors in memory
+// Prints the average id distance of an edge's ends and the query times
+// for each VertexOrder; for hardware cache-miss counts run it under
+//   perf stat -e cache-misses,cache-references reorder_bench
+//
+// usage: reorder_bench [grid side] [runs]
+// built by the CMake target reorder_bench
+
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <numeric>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "csrgraph.h"
+#include "dijkstraengine.h"
+#include "graphgenerators.h"
+#include "vertexorder.h"
+
+using namespace std;
+
+// side x side grid, edges both ways between neighbors, weights 1..100
+// vertex v of the grid gets a random label
+CsrGraph shuffledGrid(int side) {
+    int n = side * side;
+    mt19937 random(1);
+    vector<int> name(n);
+    iota(name.begin(), name.end(), 0);
+    shuffle(name.begin(), name.end(), random);
+
+    // the label of grid vertex v is its id, as Graph::freeze numbers them
+    vector<vector<pair<int, int>>> rows(n);
+    auto join = [&](int a, int b) {
+        int weight = 1 + random() % 100;
+        rows[name[a]].push_back({ name[b], weight });
+        rows[name[b]].push_back({ name[a], weight });
+    };
+    for (int y = 0; y < side; ++y) {
+        for (int x = 0; x < side; ++x) {
+            if (x + 1 < side) join(y * side + x, y * side + x + 1);
+            if (y + 1 < side) join(y * side + x, (y + 1) * side + x);
+        }
+    }
+    return csrFromRows(move(rows));
+}
+
+// breadth-first search over ids only, returns the vertices reached
+int bfs(const CsrGraph& graph, int source) {
+    vector<char> visited(graph.getNumVertices(), 0);
+    vector<int> queue{ source };
+    visited[source] = 1;
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int v = queue[head];
+        for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+            int u = graph.edgeTarget(e);
+            if (!visited[u]) {
+                visited[u] = 1;
+                queue.push_back(u);
+            }
+        }
+    }
+    return static_cast<int>(queue.size());
+}
+
+int main(int argc, char* argv[]) {
+    int side = argc > 1 ? atoi(argv[1]) : 1000;
+    int runs = argc > 2 ? atoi(argv[2]) : 3;
+    CsrGraph byLabel = shuffledGrid(side);
+    string source = byLabel.getLabel(0);
+    cout << "grid " << byLabel.getNumVertices() << " vertices "
+        << byLabel.getNumEdges() << " edges" << endl;
+
+    const pair<const char*, VertexOrder> orders[] = {
+        { "label ", VertexOrder::Label },
+        { "bfs   ", VertexOrder::Bfs },
+        { "degree", VertexOrder::Degree },
+        { "rcm   ", VertexOrder::ReverseCuthillMcKee } };
+    long long checksum = 0;
+    for (const auto& order : orders) {
+        auto start = chrono::steady_clock::now();
+        CsrGraph graph = byLabel.reorder(order.second);
+        chrono::duration<double, milli> build =
+            chrono::steady_clock::now() - start;
+        int from = graph.findVertex(source);
+        DijkstraEngine engine;
+        double bfsTime = timeBest(runs, [&] { checksum += bfs(graph, from); });
+        double dijkstraTime = timeBest(runs, [&] { engine.run(graph, from); });
+        cout << order.first << "  span " << averageEdgeSpan(graph)
+            << "  reorder " << build.count() << " ms  bfs " << bfsTime
+            << " ms  dijkstra " << dijkstraTime << " ms" << endl;
+    }
+    return checksum > 0 ? 0 : 1;
+}
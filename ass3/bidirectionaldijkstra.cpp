@@ -0,0 +1,152 @@
+#include <algorithm>
+#include <climits>
+
+#include "bidirectionaldijkstra.h"
+#include "dijkstraengine.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+/** constructor, no memory is allocated until the first query */
+BidirectionalDijkstra::BidirectionalDijkstra() : settled(0) {}
+
+/** return the lowest cost from source to target, INT_MAX if target
+    cannot be reached
+    edge weights must not be negative, if there are any a full
+    one-directional search is run instead */
+int BidirectionalDijkstra::run(const CsrGraph& graph, int source,
+                               int target) {
+    path.clear();
+    settled = 0;
+    int n = graph.getNumVertices();
+    if (source < 0 || source >= n || target < 0 || target >= n) {
+        return INT_MAX;
+    }
+
+    if (graph.hasNegativeWeights()) {
+        DijkstraEngine engine;
+        engine.run(graph, source);
+        const std::vector<int>& pred = engine.getPredecessors();
+        int cost = engine.getDistances()[target];
+        if (cost == INT_MAX) return INT_MAX;
+        for (int v = target; v >= 0; v = pred[v]) {
+            path.push_back(v);
+            if (v == source) break;
+        }
+        std::reverse(path.begin(), path.end());
+        return cost;
+    }
+
+    prepare(graph);
+    forwardDistance[source] = 0;
+    backwardDistance[target] = 0;
+    touched.push_back(source);
+    touched.push_back(target);
+    forwardHeap.update(source, 0);
+    backwardHeap.update(target, 0);
+
+    // best known path cost and the vertex where it crosses over
+    long long best = source == target ? 0 : LLONG_MAX;
+    int meet = source == target ? source : -1;
+
+    while (!forwardHeap.empty() && !backwardHeap.empty()) {
+        long long forwardKey = forwardHeap.topKey();
+        long long backwardKey = backwardHeap.topKey();
+        if (forwardKey + backwardKey >= best) break;
+        ++settled;
+
+        if (forwardKey <= backwardKey) {
+            int v = forwardHeap.pop();
+            for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+                int u = graph.edgeTarget(e);
+                int cost = forwardDistance[v] + graph.edgeWeight(e);
+                if (cost < forwardDistance[u]) {
+                    if (forwardDistance[u] == INT_MAX &&
+                        backwardDistance[u] == INT_MAX) {
+                        touched.push_back(u);
+                    }
+                    forwardDistance[u] = cost;
+                    forwardParent[u] = v;
+                    forwardHeap.update(u, cost);
+                }
+                if (backwardDistance[u] != INT_MAX &&
+                    static_cast<long long>(forwardDistance[u]) +
+                    backwardDistance[u] < best) {
+                    best = static_cast<long long>(forwardDistance[u]) +
+                        backwardDistance[u];
+                    meet = u;
+                }
+            }
+        } else {
+            int v = backwardHeap.pop();
+            for (int e = graph.inEdgeBegin(v); e < graph.inEdgeEnd(v); ++e) {
+                int u = graph.inEdgeSource(e);
+                int cost = backwardDistance[v] + graph.inEdgeWeight(e);
+                if (cost < backwardDistance[u]) {
+                    if (forwardDistance[u] == INT_MAX &&
+                        backwardDistance[u] == INT_MAX) {
+                        touched.push_back(u);
+                    }
+                    backwardDistance[u] = cost;
+                    backwardParent[u] = v;
+                    backwardHeap.update(u, cost);
+                }
+                if (forwardDistance[u] != INT_MAX &&
+                    static_cast<long long>(forwardDistance[u]) +
+                    backwardDistance[u] < best) {
+                    best = static_cast<long long>(forwardDistance[u]) +
+                        backwardDistance[u];
+                    meet = u;
+                }
+            }
+        }
+    }
+
+    int cost = INT_MAX;
+    if (meet >= 0) {
+        cost = static_cast<int>(best);
+        for (int v = meet; v >= 0; v = forwardParent[v]) {
+            path.push_back(v);
+        }
+        std::reverse(path.begin(), path.end());
+        for (int v = backwardParent[meet]; v >= 0; v = backwardParent[v]) {
+            path.push_back(v);
+        }
+    }
+    cleanup();
+    return cost;
+}
+
+/** vertex ids on the path found by the last run, source first
+    empty if the target could not be reached */
+const std::vector<int>& BidirectionalDijkstra::getPath() const {
+    return path;
+}
+
+/** number of vertices taken off a heap by the last run */
+int BidirectionalDijkstra::getSettledCount() const { return settled; }
+
+/** make the arrays big enough for graph, all entries unset */
+void BidirectionalDijkstra::prepare(const CsrGraph& graph) {
+    int n = graph.getNumVertices();
+    if (static_cast<int>(forwardDistance.size()) < n) {
+        forwardDistance.resize(n, INT_MAX);
+        backwardDistance.resize(n, INT_MAX);
+        forwardParent.resize(n, -1);
+        backwardParent.resize(n, -1);
+    }
+    forwardHeap.reserve(n);
+    backwardHeap.reserve(n);
+}
+
+/** put every touched entry back to unset */
+void BidirectionalDijkstra::cleanup() {
+    for (int v : touched) {
+        forwardDistance[v] = backwardDistance[v] = INT_MAX;
+        forwardParent[v] = backwardParent[v] = -1;
+    }
+    touched.clear();
+    forwardHeap.clear();
+    backwardHeap.clear();
+}
@@ -0,0 +1,69 @@
+/**
+ * Point-to-point shortest path on a CsrGraph
+ * Runs Dijkstra forward from the source and backward from the target at
+ * the same time, and stops once the two searches have met and no shorter
+ * path can exist: when the smallest keys of the two heaps add up to at
+ * least the best path found so far
+ * Only the vertices touched by a query are reset afterwards, so a search
+ * object reused for many queries costs time proportional to the part of
+ * the graph it explores, not to the size of the graph
+ * A search object is not thread safe, use one per thread
+ */
+
+#ifndef BIDIRECTIONALDIJKSTRA_H
+#define BIDIRECTIONALDIJKSTRA_H
+
+#include <vector>
+
+#include "csrgraph.h"
+#include "priorityqueues.h"
+
+class BidirectionalDijkstra {
+ public:
+    /** constructor, no memory is allocated until the first query */
+    BidirectionalDijkstra();
+
+    /** return the lowest cost from source to target, INT_MAX if target
+        cannot be reached
+        edge weights must not be negative, if there are any a full
+        one-directional search is run instead */
+    int run(const CsrGraph& graph, int source, int target);
+
+    /** vertex ids on the path found by the last run, source first
+        empty if the target could not be reached */
+    const std::vector<int>& getPath() const;
+
+    /** number of vertices taken off a heap by the last run */
+    int getSettledCount() const;
+
+ private:
+    /** cost from the source, INT_MAX if not reached yet */
+    std::vector<int> forwardDistance;
+
+    /** cost to the target, INT_MAX if not reached yet */
+    std::vector<int> backwardDistance;
+
+    /** previous vertex towards the source, -1 if none */
+    std::vector<int> forwardParent;
+
+    /** next vertex towards the target, -1 if none */
+    std::vector<int> backwardParent;
+
+    /** vertices whose entries above must be reset after a run */
+    std::vector<int> touched;
+
+    IndexedDaryHeap<4> forwardHeap;
+    IndexedDaryHeap<4> backwardHeap;
+
+    /** result of the last run */
+    std::vector<int> path;
+    int settled;
+
+    /** make the arrays big enough for graph, all entries unset */
+    void prepare(const CsrGraph& graph);
+
+    /** put every touched entry back to unset */
+    void cleanup();
+};  // end BidirectionalDijkstra
+
+#endif  // BIDIRECTIONALDIJKSTRA_H
@@ -0,0 +1,135 @@
+#include <algorithm>
+#include <climits>
+
+#include "chsearch.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+/** constructor, no memory is allocated until the first query */
+ChSearch::ChSearch() : settled(0) {}
+
+/** return the lowest cost from source to target, INT_MAX if target
+    cannot be reached */
+int ChSearch::run(const ContractionHierarchy& hierarchy, int source,
+                  int target) {
+    path.clear();
+    settled = 0;
+    int n = hierarchy.getNumVertices();
+    if (source < 0 || source >= n || target < 0 || target >= n) {
+        return INT_MAX;
+    }
+    if (static_cast<int>(forwardDistance.size()) < n) {
+        forwardDistance.resize(n, INT_MAX);
+        backwardDistance.resize(n, INT_MAX);
+        forwardParent.resize(n, -1);
+        backwardParent.resize(n, -1);
+    }
+    forwardHeap.reserve(n);
+    backwardHeap.reserve(n);
+
+    forwardDistance[source] = 0;
+    backwardDistance[target] = 0;
+    touched.push_back(source);
+    touched.push_back(target);
+    forwardHeap.update(source, 0);
+    backwardHeap.update(target, 0);
+    long long best = source == target ? 0 : LLONG_MAX;
+    int meet = source == target ? source : -1;
+
+    // alternate directions, each stops once it cannot improve best
+    bool forward = true;
+    for (;;) {
+        bool forwardDone = forwardHeap.empty() ||
+            forwardHeap.topKey() >= best;
+        bool backwardDone = backwardHeap.empty() ||
+            backwardHeap.topKey() >= best;
+        if (forwardDone && backwardDone) break;
+        if (forwardDone) forward = false;
+        if (backwardDone) forward = true;
+
+        if (forward) {
+            int v = forwardHeap.pop();
+            ++settled;
+            if (backwardDistance[v] != INT_MAX &&
+                static_cast<long long>(forwardDistance[v]) +
+                backwardDistance[v] < best) {
+                best = static_cast<long long>(forwardDistance[v]) +
+                    backwardDistance[v];
+                meet = v;
+            }
+            for (int e = hierarchy.upBegin(v); e < hierarchy.upEnd(v); ++e) {
+                int u = hierarchy.upTarget(e);
+                int cost = forwardDistance[v] + hierarchy.upWeight(e);
+                if (cost < forwardDistance[u]) {
+                    if (forwardDistance[u] == INT_MAX &&
+                        backwardDistance[u] == INT_MAX) {
+                        touched.push_back(u);
+                    }
+                    forwardDistance[u] = cost;
+                    forwardParent[u] = v;
+                    forwardHeap.update(u, cost);
+                }
+            }
+        } else {
+            int v = backwardHeap.pop();
+            ++settled;
+            if (forwardDistance[v] != INT_MAX &&
+                static_cast<long long>(forwardDistance[v]) +
+                backwardDistance[v] < best) {
+                best = static_cast<long long>(forwardDistance[v]) +
+                    backwardDistance[v];
+                meet = v;
+            }
+            for (int e = hierarchy.downBegin(v); e < hierarchy.downEnd(v);
+                 ++e) {
+                int u = hierarchy.downSource(e);
+                int cost = backwardDistance[v] + hierarchy.downWeight(e);
+                if (cost < backwardDistance[u]) {
+                    if (forwardDistance[u] == INT_MAX &&
+                        backwardDistance[u] == INT_MAX) {
+                        touched.push_back(u);
+                    }
+                    backwardDistance[u] = cost;
+                    backwardParent[u] = v;
+                    backwardHeap.update(u, cost);
+                }
+            }
+        }
+        forward = !forward;
+    }
+
+    int cost = INT_MAX;
+    if (meet >= 0) {
+        cost = static_cast<int>(best);
+        // the upward half is walked backwards, then unpacked in order
+        std::vector<int> up;
+        for (int v = meet; v >= 0; v = forwardParent[v]) {
+            up.push_back(v);
+        }
+        path.push_back(source);
+        for (size_t i = up.size() - 1; i > 0; --i) {
+            hierarchy.unpackEdge(up[i], up[i - 1], path);
+        }
+        for (int v = meet; backwardParent[v] >= 0; v = backwardParent[v]) {
+            hierarchy.unpackEdge(v, backwardParent[v], path);
+        }
+    }
+
+    for (int v : touched) {
+        forwardDistance[v] = backwardDistance[v] = INT_MAX;
+        forwardParent[v] = backwardParent[v] = -1;
+    }
+    touched.clear();
+    forwardHeap.clear();
+    backwardHeap.clear();
+    return cost;
+}
+
+/** vertex ids on the path found by the last run, source first,
+    shortcuts unpacked; empty if the target could not be reached */
+const std::vector<int>& ChSearch::getPath() const { return path; }
+
+/** number of vertices taken off a heap by the last run */
+int ChSearch::getSettledCount() const { return settled; }
@@ -0,0 +1,59 @@
+/**
+ * Point-to-point query on a ContractionHierarchy
+ * Searches forward from the source over upward edges and backward from
+ * the target over downward edges. The best path is the cheapest vertex
+ * reached by both; each direction stops once its smallest key is not
+ * below that cost. The path found is unpacked to original edges
+ * Only the vertices touched by a query are reset afterwards
+ * A search object is not thread safe, use one per thread
+ */
+
+#ifndef CHSEARCH_H
+#define CHSEARCH_H
+
+#include <vector>
+
+#include "contractionhierarchy.h"
+#include "priorityqueues.h"
+
+class ChSearch {
+ public:
+    /** constructor, no memory is allocated until the first query */
+    ChSearch();
+
+    /** return the lowest cost from source to target, INT_MAX if target
+        cannot be reached */
+    int run(const ContractionHierarchy& hierarchy, int source, int target);
+
+    /** vertex ids on the path found by the last run, source first,
+        shortcuts unpacked; empty if the target could not be reached */
+    const std::vector<int>& getPath() const;
+
+    /** number of vertices taken off a heap by the last run */
+    int getSettledCount() const;
+
+ private:
+    /** cost from the source, INT_MAX if not reached yet */
+    std::vector<int> forwardDistance;
+
+    /** cost to the target, INT_MAX if not reached yet */
+    std::vector<int> backwardDistance;
+
+    /** previous vertex towards the source, -1 if none */
+    std::vector<int> forwardParent;
+
+    /** next vertex towards the target, -1 if none */
+    std::vector<int> backwardParent;
+
+    /** vertices whose entries above must be reset after a run */
+    std::vector<int> touched;
+
+    IndexedDaryHeap<4> forwardHeap;
+    IndexedDaryHeap<4> backwardHeap;
+
+    /** result of the last run */
+    std::vector<int> path;
+    int settled;
+};  // end ChSearch
+
+#endif  // CHSEARCH_H
@@ -0,0 +1,302 @@
+#include <algorithm>
+#include <atomic>
+#include <utility>
+
+#include "components.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/** vertices per chunk handed to a thread */
+const int kGrain = 1024;
+
+/** graphs with fewer vertices use Tarjan, the coloring rounds would
+    cost more than they save */
+const int kParallelVertices = 1 << 16;
+
+/** root of v, halving the path to it on the way */
+int findRoot(std::vector<std::atomic<int>>& parent, int v) {
+    while (true) {
+        int p = parent[v].load(std::memory_order_relaxed);
+        if (p == v) return v;
+        int grandparent = parent[p].load(std::memory_order_relaxed);
+        if (p != grandparent) {
+            parent[v].compare_exchange_weak(p, grandparent,
+                                            std::memory_order_relaxed);
+        }
+        v = grandparent;
+    }
+}
+
+/** join the sets of a and b, the smaller root becomes the root */
+void unite(std::vector<std::atomic<int>>& parent, int a, int b) {
+    while (true) {
+        a = findRoot(parent, a);
+        b = findRoot(parent, b);
+        if (a == b) return;
+        if (a < b) std::swap(a, b);
+        // only a root may be linked, a failed exchange means a moved
+        int expected = a;
+        if (parent[a].compare_exchange_strong(expected, b)) return;
+    }
+}
+
+/** renumber a component array in order of each component's smallest
+    vertex, return the number of components */
+int renumber(std::vector<int>& component) {
+    std::vector<int> newId(component.size(), -1);
+    int count = 0;
+    for (int& c : component) {
+        if (newId[c] < 0) newId[c] = count++;
+        c = newId[c];
+    }
+    return count;
+}
+
+/** raise word to at least value, return true if it went up */
+bool raiseTo(std::atomic<int>& word, int value) {
+    int seen = word.load(std::memory_order_relaxed);
+    while (seen < value) {
+        if (word.compare_exchange_weak(seen, value,
+                                       std::memory_order_relaxed)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace
+
+/** compute the weak and strong components of graph on pool
+    the condensation keeps a copy of the edges between components */
+Components::Components(const CsrGraph& graph, ThreadPool& pool) {
+    weak = weakComponents(graph, pool);
+    numWeak = 0;
+    for (int c : weak) {
+        numWeak = std::max(numWeak, c + 1);
+    }
+    int n = graph.getNumVertices();
+    if (n < kParallelVertices || pool.getNumThreads() == 1) {
+        strong = strongComponentsTarjan(graph);
+    } else {
+        strong = strongComponentsColoring(graph, pool);
+    }
+    numStrong = 0;
+    for (int c : strong) {
+        numStrong = std::max(numStrong, c + 1);
+    }
+
+    // components are numbered by smallest vertex, so the first vertex
+    // met of each one names it
+    std::vector<std::string> labels;
+    labels.reserve(numStrong);
+    std::vector<std::vector<std::pair<int, int>>> rows(numStrong);
+    for (int v = 0; v < n; ++v) {
+        int from = strong[v];
+        if (from == static_cast<int>(labels.size())) {
+            labels.push_back(graph.getLabel(v));
+        }
+        for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+            int to = strong[graph.edgeTarget(e)];
+            if (to != from) rows[from].push_back({ to, graph.edgeWeight(e) });
+        }
+    }
+    std::vector<int> offsets(1, 0);
+    std::vector<int> targets;
+    std::vector<int> weights;
+    for (std::vector<std::pair<int, int>>& row : rows) {
+        // sorted by target then weight, so the first of each is lowest
+        std::sort(row.begin(), row.end());
+        for (size_t i = 0; i < row.size(); ++i) {
+            if (i > 0 && row[i].first == row[i - 1].first) continue;
+            targets.push_back(row[i].first);
+            weights.push_back(row[i].second);
+        }
+        offsets.push_back(static_cast<int>(targets.size()));
+    }
+    condensation = CsrGraph(std::move(labels), std::move(offsets),
+                            std::move(targets), std::move(weights));
+}
+
+/** return number of weakly connected components */
+int Components::getNumWeak() const { return numWeak; }
+
+/** weak component of every vertex */
+const std::vector<int>& Components::getWeakIds() const { return weak; }
+
+/** return number of strongly connected components */
+int Components::getNumStrong() const { return numStrong; }
+
+/** strong component of every vertex */
+const std::vector<int>& Components::getStrongIds() const { return strong; }
+
+/** the graph of the strong components, a DAG: vertex c stands for
+    component c and has the label of its smallest vertex, an edge
+    joins two components if any edge does, with the lowest weight */
+const CsrGraph& Components::getCondensation() const { return condensation; }
+
+/** weak components by union-find, ids in order of smallest vertex */
+std::vector<int> Components::weakComponents(const CsrGraph& graph,
+                                            ThreadPool& pool) {
+    int n = graph.getNumVertices();
+    std::vector<std::atomic<int>> parent(n);
+    for (int v = 0; v < n; ++v) {
+        parent[v].store(v, std::memory_order_relaxed);
+    }
+    pool.parallelFor(0, n, kGrain, [&](int first, int last, int) {
+        for (int v = first; v < last; ++v) {
+            for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+                unite(parent, v, graph.edgeTarget(e));
+            }
+        }
+    });
+
+    // each root is the smallest id of its set, so it comes first
+    std::vector<int> component(n);
+    for (int v = 0; v < n; ++v) {
+        component[v] = findRoot(parent, v);
+    }
+    renumber(component);
+    return component;
+}
+
+/** strong components by iterative Tarjan */
+std::vector<int> Components::strongComponentsTarjan(const CsrGraph& graph) {
+    int n = graph.getNumVertices();
+    std::vector<int> component(n, -1);
+    std::vector<int> index(n, -1);
+    std::vector<int> lowLink(n, 0);
+    std::vector<int> members;
+    // each entry is a vertex and the next edge to look at
+    std::vector<std::pair<int, int>> calls;
+    int nextIndex = 0;
+    int count = 0;
+    for (int root = 0; root < n; ++root) {
+        if (index[root] >= 0) continue;
+        index[root] = lowLink[root] = nextIndex++;
+        members.push_back(root);
+        calls.push_back({ root, graph.edgeBegin(root) });
+        while (!calls.empty()) {
+            int v = calls.back().first;
+            int& e = calls.back().second;
+            if (e < graph.edgeEnd(v)) {
+                int u = graph.edgeTarget(e++);
+                if (index[u] < 0) {
+                    index[u] = lowLink[u] = nextIndex++;
+                    members.push_back(u);
+                    calls.push_back({ u, graph.edgeBegin(u) });
+                } else if (component[u] < 0) {
+                    lowLink[v] = std::min(lowLink[v], index[u]);
+                }
+                continue;
+            }
+            calls.pop_back();
+            if (!calls.empty()) {
+                int caller = calls.back().first;
+                lowLink[caller] = std::min(lowLink[caller], lowLink[v]);
+            }
+            if (lowLink[v] == index[v]) {
+                int u;
+                do {
+                    u = members.back();
+                    members.pop_back();
+                    component[u] = count;
+                } while (u != v);
+                ++count;
+            }
+        }
+    }
+    renumber(component);
+    return component;
+}
+
+/** strong components by parallel forward-backward coloring */
+std::vector<int> Components::strongComponentsColoring(const CsrGraph& graph,
+                                                      ThreadPool& pool) {
+    int n = graph.getNumVertices();
+    std::vector<int> component(n, -1);
+    std::vector<std::atomic<int>> color(n);
+    std::vector<std::vector<int>> queues(pool.getNumThreads());
+
+    // a vertex without edges in or out is a component of its own
+    std::vector<int> active;
+    for (int v = 0; v < n; ++v) {
+        if (graph.edgeBegin(v) == graph.edgeEnd(v) ||
+            graph.inEdgeBegin(v) == graph.inEdgeEnd(v)) {
+            component[v] = v;
+        } else {
+            active.push_back(v);
+        }
+    }
+
+    std::vector<int> roots;
+    while (!active.empty()) {
+        int size = static_cast<int>(active.size());
+        for (int v : active) {
+            color[v].store(v, std::memory_order_relaxed);
+        }
+        // forward: every vertex ends with the largest id reaching it
+        std::atomic<bool> changed(true);
+        while (changed.load()) {
+            changed.store(false);
+            pool.parallelFor(0, size, kGrain, [&](int first, int last, int) {
+                bool raised = false;
+                for (int i = first; i < last; ++i) {
+                    int v = active[i];
+                    int c = color[v].load(std::memory_order_relaxed);
+                    for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v);
+                         ++e) {
+                        int u = graph.edgeTarget(e);
+                        if (component[u] < 0 && raiseTo(color[u], c)) {
+                            raised = true;
+                        }
+                    }
+                }
+                if (raised) changed.store(true, std::memory_order_relaxed);
+            });
+        }
+
+        // backward: a root collects the vertices of its color that
+        // reach it; colors do not overlap, so roots run side by side
+        roots.clear();
+        for (int v : active) {
+            if (color[v].load(std::memory_order_relaxed) == v) {
+                roots.push_back(v);
+            }
+        }
+        pool.parallelFor(0, static_cast<int>(roots.size()), 1,
+            [&](int first, int last, int thread) {
+            std::vector<int>& queue = queues[thread];
+            for (int i = first; i < last; ++i) {
+                int root = roots[i];
+                queue.assign(1, root);
+                component[root] = root;
+                for (size_t head = 0; head < queue.size(); ++head) {
+                    int v = queue[head];
+                    for (int e = graph.inEdgeBegin(v); e < graph.inEdgeEnd(v);
+                         ++e) {
+                        int u = graph.inEdgeSource(e);
+                        // the color decides first, only vertices of this
+                        // color are written by this root
+                        if (color[u].load(std::memory_order_relaxed) == root
+                            && component[u] < 0) {
+                            component[u] = root;
+                            queue.push_back(u);
+                        }
+                    }
+                }
+            }
+        });
+
+        active.erase(std::remove_if(active.begin(), active.end(),
+                                    [&component](int v) {
+                                        return component[v] >= 0;
+                                    }),
+                     active.end());
+    }
+    renumber(component);
+    return component;
+}
@@ -0,0 +1,74 @@
+/**
+ * Weakly and strongly connected components of a CsrGraph
+ * Weak components come from a lock-free union-find: the threads of a
+ * pool link the ends of every edge with compare-and-swap, always hanging
+ * the larger root under the smaller, so each root ends up being the
+ * smallest id of its component
+ * Strong components come from an iterative Tarjan search, or for large
+ * graphs from the parallel coloring variant of forward-backward search:
+ * every vertex takes the largest id that reaches it, then each vertex
+ * whose color is its own id collects the vertices of its color that it
+ * can reach backwards, which is its component; the rest start again
+ * Both kinds are numbered in order of their smallest vertex id, so the
+ * result does not depend on the algorithm or the number of threads
+ */
+
+#ifndef COMPONENTS_H
+#define COMPONENTS_H
+
+#include <vector>
+
+#include "csrgraph.h"
+#include "threadpool.h"
+
+class Components {
+ public:
+    /** compute the weak and strong components of graph on pool
+        the condensation keeps a copy of the edges between components */
+    Components(const CsrGraph& graph, ThreadPool& pool);
+
+    /** return number of weakly connected components */
+    int getNumWeak() const;
+
+    /** weak component of vertex id */
+    int getWeak(int id) const { return weak[id]; }
+
+    /** weak component of every vertex */
+    const std::vector<int>& getWeakIds() const;
+
+    /** return number of strongly connected components */
+    int getNumStrong() const;
+
+    /** strong component of vertex id */
+    int getStrong(int id) const { return strong[id]; }
+
+    /** strong component of every vertex */
+    const std::vector<int>& getStrongIds() const;
+
+    /** the graph of the strong components, a DAG: vertex c stands for
+        component c and has the label of its smallest vertex, an edge
+        joins two components if any edge does, with the lowest weight */
+    const CsrGraph& getCondensation() const;
+
+    /** weak components by union-find, ids in order of smallest vertex */
+    static std::vector<int> weakComponents(const CsrGraph& graph,
+                                           ThreadPool& pool);
+
+    /** strong components by iterative Tarjan */
+    static std::vector<int> strongComponentsTarjan(const CsrGraph& graph);
+
+    /** strong components by parallel forward-backward coloring */
+    static std::vector<int> strongComponentsColoring(const CsrGraph& graph,
+                                                     ThreadPool& pool);
+
+ private:
+    std::vector<int> weak;
+    int numWeak;
+
+    std::vector<int> strong;
+    int numStrong;
+
+    CsrGraph condensation;
+};  // end Components
+
+#endif  // COMPONENTS_H
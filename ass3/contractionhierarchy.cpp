@@ -0,0 +1,280 @@
+#include <algorithm>
+#include <climits>
+#include <functional>
+#include <queue>
+#include <utility>
+
+#include "contractionhierarchy.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/** edge of the graph being contracted, seen from one of its ends */
+struct Arc {
+    int other;
+    int weight;
+    int middle;
+};
+
+/** a witness search gives up after settling this many vertices
+    giving up early only means an unneeded shortcut may be added */
+const int kWitnessSettleLimit = 500;
+
+/** the graph during contraction, with a scratch Dijkstra for witness
+    searches whose arrays are reset only where they were touched */
+class Contractor {
+ public:
+    explicit Contractor(const CsrGraph& graph);
+
+    /** number of shortcuts contracting v would add */
+    int countShortcuts(int v);
+
+    /** contract v and add its shortcuts, return how many were added */
+    int contract(int v);
+
+    /** importance of v, lower is contracted first */
+    int priority(int v);
+
+    std::vector<std::vector<Arc>> outArcs;
+    std::vector<std::vector<Arc>> inArcs;
+    std::vector<char> contracted;
+    std::vector<int> contractedNeighbors;
+
+ private:
+    std::vector<int> distance;
+    std::vector<int> touched;
+
+    /** costs from u to remaining vertices without passing v, stops at
+        limit or after kWitnessSettleLimit settled vertices */
+    void witnessSearch(int u, int v, int limit);
+
+    /** shortcuts u->w needed when v is removed, as (u, arc to w) */
+    void findShortcuts(int v, std::vector<std::pair<int, Arc>>& shortcuts);
+
+    /** add edge u->w or lower its weight */
+    void addArc(int u, int w, int weight, int middle);
+};
+
+Contractor::Contractor(const CsrGraph& graph) {
+    int n = graph.getNumVertices();
+    outArcs.resize(n);
+    inArcs.resize(n);
+    contracted.assign(n, 0);
+    contractedNeighbors.assign(n, 0);
+    distance.assign(n, INT_MAX);
+    for (int v = 0; v < n; ++v) {
+        for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+            if (graph.edgeTarget(e) != v) {
+                addArc(v, graph.edgeTarget(e), graph.edgeWeight(e), -1);
+            }
+        }
+    }
+}
+
+void Contractor::addArc(int u, int w, int weight, int middle) {
+    for (Arc& arc : outArcs[u]) {
+        if (arc.other != w) continue;
+        if (weight < arc.weight) {
+            arc.weight = weight;
+            arc.middle = middle;
+            for (Arc& back : inArcs[w]) {
+                if (back.other == u) {
+                    back.weight = weight;
+                    back.middle = middle;
+                }
+            }
+        }
+        return;
+    }
+    outArcs[u].push_back({ w, weight, middle });
+    inArcs[w].push_back({ u, weight, middle });
+}
+
+void Contractor::witnessSearch(int u, int v, int limit) {
+    for (int t : touched) distance[t] = INT_MAX;
+    touched.clear();
+
+    typedef std::pair<int, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq;
+    distance[u] = 0;
+    touched.push_back(u);
+    pq.push({ 0, u });
+    int settled = 0;
+    while (!pq.empty() && settled < kWitnessSettleLimit) {
+        Entry top = pq.top();
+        pq.pop();
+        int x = top.second;
+        if (top.first > distance[x]) continue;
+        if (top.first > limit) break;
+        ++settled;
+        for (const Arc& arc : outArcs[x]) {
+            int y = arc.other;
+            if (y == v || contracted[y]) continue;
+            int cost = top.first + arc.weight;
+            if (cost < distance[y]) {
+                if (distance[y] == INT_MAX) touched.push_back(y);
+                distance[y] = cost;
+                pq.push({ cost, y });
+            }
+        }
+    }
+}
+
+void Contractor::findShortcuts(int v,
+                               std::vector<std::pair<int, Arc>>& shortcuts) {
+    shortcuts.clear();
+    int longestOut = 0;
+    for (const Arc& out : outArcs[v]) {
+        if (!contracted[out.other] && out.weight > longestOut) {
+            longestOut = out.weight;
+        }
+    }
+    for (const Arc& in : inArcs[v]) {
+        if (contracted[in.other]) continue;
+        int u = in.other;
+        witnessSearch(u, v, in.weight + longestOut);
+        for (const Arc& out : outArcs[v]) {
+            int w = out.other;
+            if (w == u || contracted[w]) continue;
+            int through = in.weight + out.weight;
+            if (distance[w] > through) {
+                shortcuts.push_back({ u, { w, through, v } });
+            }
+        }
+    }
+}
+
+int Contractor::countShortcuts(int v) {
+    std::vector<std::pair<int, Arc>> shortcuts;
+    findShortcuts(v, shortcuts);
+    return static_cast<int>(shortcuts.size());
+}
+
+int Contractor::priority(int v) {
+    int degree = 0;
+    for (const Arc& arc : outArcs[v]) degree += !contracted[arc.other];
+    for (const Arc& arc : inArcs[v]) degree += !contracted[arc.other];
+    // edge difference, plus spreading contraction evenly over the graph
+    return countShortcuts(v) - degree + contractedNeighbors[v];
+}
+
+int Contractor::contract(int v) {
+    std::vector<std::pair<int, Arc>> shortcuts;
+    findShortcuts(v, shortcuts);
+    for (const auto& shortcut : shortcuts) {
+        addArc(shortcut.first, shortcut.second.other, shortcut.second.weight,
+               shortcut.second.middle);
+    }
+    contracted[v] = 1;
+    for (const Arc& arc : outArcs[v]) ++contractedNeighbors[arc.other];
+    for (const Arc& arc : inArcs[v]) ++contractedNeighbors[arc.other];
+    return static_cast<int>(shortcuts.size());
+}
+
+}  // namespace
+
+/** constructor, empty hierarchy */
+ContractionHierarchy::ContractionHierarchy()
+    : numVertices(0), numShortcuts(0), upOffsets(1, 0), downOffsets(1, 0) {}
+
+/** contract every vertex of graph
+    return false if graph has negative edge weights, the hierarchy
+    is then left empty */
+bool ContractionHierarchy::build(const CsrGraph& graph) {
+    *this = ContractionHierarchy();
+    if (graph.hasNegativeWeights()) return false;
+
+    int n = graph.getNumVertices();
+    Contractor contractor(graph);
+
+    // lazy updates: a popped vertex whose priority went up is pushed back
+    typedef std::pair<int, int> Entry;
+    std::priority_queue<Entry, std::vector<Entry>, std::greater<Entry>> pq;
+    for (int v = 0; v < n; ++v) {
+        pq.push({ contractor.priority(v), v });
+    }
+    rank.assign(n, 0);
+    int next = 0;
+    while (!pq.empty()) {
+        int v = pq.top().second;
+        pq.pop();
+        int current = contractor.priority(v);
+        if (!pq.empty() && current > pq.top().first) {
+            pq.push({ current, v });
+            continue;
+        }
+        numShortcuts += contractor.contract(v);
+        rank[v] = next++;
+    }
+
+    // split the final edges by rank into sorted upward and downward blocks
+    numVertices = n;
+    upOffsets.assign(n + 1, 0);
+    downOffsets.assign(n + 1, 0);
+    for (int v = 0; v < n; ++v) {
+        std::vector<Arc>& outs = contractor.outArcs[v];
+        std::vector<Arc>& ins = contractor.inArcs[v];
+        std::sort(outs.begin(), outs.end(),
+                  [](const Arc& a, const Arc& b) { return a.other < b.other; });
+        std::sort(ins.begin(), ins.end(),
+                  [](const Arc& a, const Arc& b) { return a.other < b.other; });
+        for (const Arc& arc : outs) {
+            if (rank[arc.other] < rank[v]) continue;
+            upTargets.push_back(arc.other);
+            upWeights.push_back(arc.weight);
+            upMiddle.push_back(arc.middle);
+        }
+        for (const Arc& arc : ins) {
+            if (rank[arc.other] < rank[v]) continue;
+            downSources.push_back(arc.other);
+            downWeights.push_back(arc.weight);
+            downMiddle.push_back(arc.middle);
+        }
+        upOffsets[v + 1] = static_cast<int>(upTargets.size());
+        downOffsets[v + 1] = static_cast<int>(downSources.size());
+    }
+    return true;
+}
+
+/** return number of vertices */
+int ContractionHierarchy::getNumVertices() const { return numVertices; }
+
+/** return number of shortcut edges added by build */
+int ContractionHierarchy::getNumShortcuts() const { return numShortcuts; }
+
+/** append the original vertices of edge from->to, without from
+    the edge must exist in the hierarchy */
+void ContractionHierarchy::unpackEdge(int from, int to,
+                                      std::vector<int>& path) const {
+    // explicit stack, shortcuts of shortcuts can nest deeply
+    std::vector<std::pair<int, int>> stack;
+    stack.push_back({ from, to });
+    while (!stack.empty()) {
+        std::pair<int, int> edge = stack.back();
+        stack.pop_back();
+        int middle = middleOf(edge.first, edge.second);
+        if (middle < 0) {
+            path.push_back(edge.second);
+        } else {
+            stack.push_back({ middle, edge.second });
+            stack.push_back({ edge.first, middle });
+        }
+    }
+}
+
+/** the vertex skipped by edge from->to, -1 if it is original */
+int ContractionHierarchy::middleOf(int from, int to) const {
+    if (rank[from] < rank[to]) {
+        auto first = upTargets.begin() + upOffsets[from];
+        auto last = upTargets.begin() + upOffsets[from + 1];
+        auto it = std::lower_bound(first, last, to);
+        return upMiddle[it - upTargets.begin()];
+    }
+    auto first = downSources.begin() + downOffsets[to];
+    auto last = downSources.begin() + downOffsets[to + 1];
+    auto it = std::lower_bound(first, last, from);
+    return downMiddle[it - downSources.begin()];
+}
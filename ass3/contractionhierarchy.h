@@ -0,0 +1,84 @@
+/**
+ * Contraction hierarchy of a CsrGraph for fast point-to-point queries
+ * Vertices are contracted one at a time, least important first. When a
+ * vertex v is removed, a shortcut edge u->w is added for each path
+ * u->v->w that is the only shortest path between u and w among the
+ * remaining vertices. The contraction order is the rank of a vertex
+ * Every shortest path then has an equivalent path that first goes up in
+ * rank and then comes down, so a query only needs a forward search over
+ * edges to higher ranks and a backward search over edges from higher
+ * ranks, see ChSearch
+ * Each edge remembers the vertex it skips, so paths can be unpacked back
+ * to edges of the original graph
+ */
+
+#ifndef CONTRACTIONHIERARCHY_H
+#define CONTRACTIONHIERARCHY_H
+
+#include <vector>
+
+#include "csrgraph.h"
+
+class ContractionHierarchy {
+ public:
+    /** constructor, empty hierarchy */
+    ContractionHierarchy();
+
+    /** contract every vertex of graph
+        return false if graph has negative edge weights, the hierarchy
+        is then left empty */
+    bool build(const CsrGraph& graph);
+
+    /** return number of vertices */
+    int getNumVertices() const;
+
+    /** return number of shortcut edges added by build */
+    int getNumShortcuts() const;
+
+    /** contraction order of vertex id, 0 was contracted first */
+    int getRank(int id) const { return rank[id]; }
+
+    /** edges from id to higher ranked vertices, same layout as CsrGraph
+        upMiddle is the vertex the edge skips, -1 for an original edge */
+    int upBegin(int id) const { return upOffsets[id]; }
+    int upEnd(int id) const { return upOffsets[id + 1]; }
+    int upTarget(int edge) const { return upTargets[edge]; }
+    int upWeight(int edge) const { return upWeights[edge]; }
+
+    /** edges into id from higher ranked vertices */
+    int downBegin(int id) const { return downOffsets[id]; }
+    int downEnd(int id) const { return downOffsets[id + 1]; }
+    int downSource(int edge) const { return downSources[edge]; }
+    int downWeight(int edge) const { return downWeights[edge]; }
+
+    /** append the original vertices of edge from->to, without from
+        the edge must exist in the hierarchy */
+    void unpackEdge(int from, int to, std::vector<int>& path) const;
+
+ private:
+    /** number of vertices */
+    int numVertices;
+
+    /** number of shortcuts */
+    int numShortcuts;
+
+    /** contraction order of each vertex */
+    std::vector<int> rank;
+
+    /** upward edges, one CSR block per vertex */
+    std::vector<int> upOffsets;
+    std::vector<int> upTargets;
+    std::vector<int> upWeights;
+    std::vector<int> upMiddle;
+
+    /** downward edges stored at their lower ranked end */
+    std::vector<int> downOffsets;
+    std::vector<int> downSources;
+    std::vector<int> downWeights;
+    std::vector<int> downMiddle;
+
+    /** the vertex skipped by edge from->to, -1 if it is original */
+    int middleOf(int from, int to) const;
+};  // end ContractionHierarchy
+
+#endif  // CONTRACTIONHIERARCHY_H
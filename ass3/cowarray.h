@@ -0,0 +1,66 @@
+/**
+ * Array of values split into fixed-size chunks that copies share
+ * Copying a CowArray copies only the list of chunk pointers; set and
+ * push_back copy the one chunk they change unless this array is its
+ * only owner. A published copy is therefore never changed, and readers
+ * of it need no locks, while the next copy costs one pointer per chunk
+ * plus one chunk per changed position
+ */
+
+#ifndef COWARRAY_H
+#define COWARRAY_H
+
+#include <cstddef>
+#include <memory>
+#include <vector>
+
+template <class T>
+class CowArray {
+ public:
+    /** values per chunk */
+    static const size_t kChunkSize = 256;
+
+    /** return number of values */
+    size_t size() const { return count; }
+
+    /** value at position at, which must be below size */
+    const T& operator[](size_t at) const {
+        return (*chunks[at / kChunkSize])[at % kChunkSize];
+    }
+
+    /** replace the value at position at, which must be below size */
+    void set(size_t at, T value) {
+        writable(at / kChunkSize)[at % kChunkSize] = std::move(value);
+    }
+
+    /** add value at the end */
+    void push_back(T value) {
+        if (count % kChunkSize == 0) {
+            chunks.push_back(std::make_shared<Chunk>());
+            chunks.back()->reserve(kChunkSize);
+        }
+        writable(count / kChunkSize).push_back(std::move(value));
+        ++count;
+    }
+
+ private:
+    typedef std::vector<T> Chunk;
+
+    /** chunks shared with other copies, all but the last are full */
+    std::vector<std::shared_ptr<Chunk>> chunks;
+    size_t count {0};
+
+    /** chunk c, copied first if another array shares it
+        only the writer copies arrays, so a count of 1 cannot go up */
+    Chunk& writable(size_t c) {
+        if (chunks[c].use_count() != 1) {
+            auto copy = std::make_shared<Chunk>();
+            copy->reserve(kChunkSize);
+            copy->assign(chunks[c]->begin(), chunks[c]->end());
+            chunks[c] = std::move(copy);
+        }
+        return *chunks[c];
+    }
+};  // end CowArray
+
+#endif  // COWARRAY_H
@@ -0,0 +1,483 @@
+#include <algorithm>
+#include <climits>
+#include <cstring>
+#include <fstream>
+#include <numeric>
+#include <utility>
+
+#include "csrgraph.h"
+#include "dijkstraengine.h"
+#include "mappedfile.h"
+#include "vertexorder.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/** arrays of a graph built in memory */
+struct OwnedArrays {
+    std::vector<char> labelBytes;
+    std::vector<std::uint64_t> labelOffsets;
+    std::vector<int> labelOrder;
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<int> weights;
+    std::vector<int> inOffsets;
+    std::vector<int> sources;
+    std::vector<int> inWeights;
+};
+
+/** start of a file written by saveBinary
+    the sections follow in the order label offsets, label bytes, offsets,
+    targets, weights, incoming offsets, sources, incoming weights,
+    label order, each padded with zeros to a multiple of 8 bytes */
+struct BinaryHeader {
+    char magic[4];
+    std::uint32_t version;
+    /** kByteOrder as written, catches files from other architectures */
+    std::uint32_t byteOrder;
+    /** 1 if any weight is negative */
+    std::uint32_t flags;
+    std::uint64_t numVertices;
+    std::uint64_t numEdges;
+    std::uint64_t numLabelBytes;
+    /** checksum of the sections */
+    std::uint64_t checksum;
+};
+
+const char kMagic[4] = { 'C', 'S', 'R', 'G' };
+const std::uint32_t kVersion = 2;
+
+/** number of sections after the header */
+const int kSections = 9;
+const std::uint32_t kByteOrder = 0x01020304;
+
+/** size of a section once padded */
+std::uint64_t padded(std::uint64_t size) { return (size + 7) & ~7ULL; }
+
+/** FNV-1a over 64-bit words, the last word is padded with zeros
+    so a section hashes the same in memory and in the file */
+std::uint64_t mixSection(std::uint64_t hash, const void* data,
+                         std::uint64_t size) {
+    const char* bytes = static_cast<const char*>(data);
+    for (std::uint64_t at = 0; at < size; at += 8) {
+        std::uint64_t word = 0;
+        std::memcpy(&word, bytes + at, size - at < 8 ? size - at : 8);
+        hash = (hash ^ word) * 1099511628211ULL;
+    }
+    return hash;
+}
+
+/** true if offsets has n + 1 entries rising from 0 to m */
+bool validOffsets(const int* offsets, std::uint64_t n, std::uint64_t m) {
+    if (offsets[0] != 0 || offsets[n] != static_cast<int>(m)) return false;
+    for (std::uint64_t v = 0; v < n; ++v) {
+        if (offsets[v] > offsets[v + 1]) return false;
+    }
+    return true;
+}
+
+/** true if all count ids are vertex ids below n */
+bool validIds(const int* ids, std::uint64_t count, std::uint64_t n) {
+    for (std::uint64_t i = 0; i < count; ++i) {
+        if (ids[i] < 0 || static_cast<std::uint64_t>(ids[i]) >= n) {
+            return false;
+        }
+    }
+    return true;
+}
+
+}  // namespace
+
+/** constructor, empty graph */
+CsrGraph::CsrGraph()
+    : CsrGraph(std::vector<std::string>(), std::vector<int>(1, 0),
+               std::vector<int>(), std::vector<int>()) {}
+
+/** constructor from prebuilt arrays, vertex v gets labels[v]
+    offsets must have labels.size() + 1 entries
+    targets and weights must have offsets.back() entries
+    the incoming edge arrays are derived from them */
+CsrGraph::CsrGraph(std::vector<std::string> labels, std::vector<int> offsets,
+                   std::vector<int> targets, std::vector<int> weights) {
+    auto arrays = std::make_shared<OwnedArrays>();
+    int n = static_cast<int>(labels.size());
+    size_t totalBytes = 0;
+    for (const std::string& label : labels) {
+        totalBytes += label.size();
+    }
+    arrays->labelBytes.reserve(totalBytes);
+    arrays->labelOffsets.reserve(n + 1);
+    arrays->labelOffsets.push_back(0);
+    for (const std::string& label : labels) {
+        arrays->labelBytes.insert(arrays->labelBytes.end(), label.begin(),
+                                  label.end());
+        arrays->labelOffsets.push_back(arrays->labelBytes.size());
+    }
+    arrays->labelOrder.resize(n);
+    std::iota(arrays->labelOrder.begin(), arrays->labelOrder.end(), 0);
+    if (!std::is_sorted(labels.begin(), labels.end())) {
+        std::sort(arrays->labelOrder.begin(), arrays->labelOrder.end(),
+                  [&labels](int a, int b) { return labels[a] < labels[b]; });
+    }
+    arrays->offsets = std::move(offsets);
+    arrays->targets = std::move(targets);
+    arrays->weights = std::move(weights);
+
+    for (int w : arrays->weights) {
+        if (w < 0) {
+            negativeWeights = true;
+            break;
+        }
+    }
+
+    // counting sort of the edges by target, sources stay in id order
+    std::vector<int>& in = arrays->inOffsets;
+    in.assign(n + 1, 0);
+    for (int target : arrays->targets) {
+        in[target + 1]++;
+    }
+    for (int v = 0; v < n; ++v) {
+        in[v + 1] += in[v];
+    }
+    arrays->sources.resize(arrays->targets.size());
+    arrays->inWeights.resize(arrays->targets.size());
+    std::vector<int> fill(in.begin(), in.end() - 1);
+    for (int v = 0; v < n; ++v) {
+        for (int e = arrays->offsets[v]; e < arrays->offsets[v + 1]; ++e) {
+            int at = fill[arrays->targets[e]]++;
+            arrays->sources[at] = v;
+            arrays->inWeights[at] = arrays->weights[e];
+        }
+    }
+
+    numVertices = n;
+    numEdges = static_cast<int>(arrays->targets.size());
+    labelBytes = arrays->labelBytes.data();
+    labelOffsets = arrays->labelOffsets.data();
+    labelOrder = arrays->labelOrder.data();
+    this->offsets = arrays->offsets.data();
+    this->targets = arrays->targets.data();
+    this->weights = arrays->weights.data();
+    inOffsets = arrays->inOffsets.data();
+    sources = arrays->sources.data();
+    inWeights = arrays->inWeights.data();
+    storage = arrays;
+}
+
+/** return number of vertices */
+int CsrGraph::getNumVertices() const { return numVertices; }
+
+/** return number of edges */
+int CsrGraph::getNumEdges() const { return numEdges; }
+
+/** return true if any edge has a negative weight */
+bool CsrGraph::hasNegativeWeights() const { return negativeWeights; }
+
+/** return a 64-bit hash of the labels, edges and weights
+    used to check that saved data belongs to this graph */
+std::uint64_t CsrGraph::fingerprint() const {
+    // FNV-1a over every byte of the graph
+    std::uint64_t hash = 14695981039346656037ULL;
+    auto mix = [&hash](const void* data, size_t size) {
+        const unsigned char* bytes = static_cast<const unsigned char*>(data);
+        for (size_t i = 0; i < size; ++i) {
+            hash = (hash ^ bytes[i]) * 1099511628211ULL;
+        }
+    };
+    for (int v = 0; v < numVertices; ++v) {
+        mix(labelBytes + labelOffsets[v],
+            labelOffsets[v + 1] - labelOffsets[v]);
+        mix("", 1);
+    }
+    mix(offsets, (numVertices + 1) * sizeof(int));
+    mix(targets, numEdges * sizeof(int));
+    mix(weights, numEdges * sizeof(int));
+    return hash;
+}
+
+/** return the id of the vertex with the given label
+    returns -1 if the vertex does not exist */
+int CsrGraph::findVertex(const std::string& vertexLabel) const {
+    int low = 0;
+    int high = numVertices;
+    while (low < high) {
+        int middle = low + (high - low) / 2;
+        int id = labelOrder[middle];
+        std::uint64_t begin = labelOffsets[id];
+        int order = vertexLabel.compare(0, std::string::npos,
+                                        labelBytes + begin,
+                                        labelOffsets[id + 1] - begin);
+        if (order == 0) return id;
+        if (order < 0) {
+            high = middle;
+        } else {
+            low = middle + 1;
+        }
+    }
+    return -1;
+}
+
+/** return a copy with the vertices renumbered in the given order
+    labels, edges and weights are unchanged, only ids differ */
+CsrGraph CsrGraph::reorder(VertexOrder order) const {
+    return permute(computeVertexOrder(*this, order));
+}
+
+/** return a copy in which vertex newId is vertex order[newId] of
+    this graph, order must hold every id once */
+CsrGraph CsrGraph::permute(const std::vector<int>& order) const {
+    std::vector<int> newId(numVertices);
+    for (int v = 0; v < numVertices; ++v) {
+        newId[order[v]] = v;
+    }
+    std::vector<std::string> labels;
+    labels.reserve(numVertices);
+    std::vector<int> newOffsets;
+    newOffsets.reserve(numVertices + 1);
+    newOffsets.push_back(0);
+    std::vector<int> newTargets(numEdges);
+    std::vector<int> newWeights(numEdges);
+    std::vector<std::pair<int, int>> row;
+    for (int v : order) {
+        labels.push_back(getLabel(v));
+        // rows stay sorted by target id in the new numbering
+        row.clear();
+        for (int e = offsets[v]; e < offsets[v + 1]; ++e) {
+            row.push_back({ newId[targets[e]], weights[e] });
+        }
+        std::sort(row.begin(), row.end());
+        int at = newOffsets.back();
+        for (const auto& edge : row) {
+            newTargets[at] = edge.first;
+            newWeights[at] = edge.second;
+            ++at;
+        }
+        newOffsets.push_back(at);
+    }
+    return CsrGraph(std::move(labels), std::move(newOffsets),
+                    std::move(newTargets), std::move(newWeights));
+}
+
+/** write the graph to filename in a versioned, checksummed binary
+    format that loadBinary maps back
+    return false if the file could not be written */
+bool CsrGraph::saveBinary(const std::string& filename) const {
+    std::uint64_t n = numVertices;
+    std::uint64_t m = numEdges;
+    const void* sections[] = { labelOffsets, labelBytes, offsets, targets,
+                               weights, inOffsets, sources, inWeights,
+                               labelOrder };
+    const std::uint64_t sizes[] = {
+        (n + 1) * sizeof(std::uint64_t), labelOffsets[n],
+        (n + 1) * sizeof(int), m * sizeof(int), m * sizeof(int),
+        (n + 1) * sizeof(int), m * sizeof(int), m * sizeof(int),
+        n * sizeof(int) };
+
+    BinaryHeader header;
+    std::memcpy(header.magic, kMagic, sizeof(kMagic));
+    header.version = kVersion;
+    header.byteOrder = kByteOrder;
+    header.flags = negativeWeights ? 1 : 0;
+    header.numVertices = n;
+    header.numEdges = m;
+    header.numLabelBytes = labelOffsets[n];
+    header.checksum = 14695981039346656037ULL;
+    for (int s = 0; s < kSections; ++s) {
+        header.checksum = mixSection(header.checksum, sections[s], sizes[s]);
+    }
+
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) return false;
+    out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    const char zeros[8] = {};
+    for (int s = 0; s < kSections; ++s) {
+        out.write(static_cast<const char*>(sections[s]), sizes[s]);
+        out.write(zeros, padded(sizes[s]) - sizes[s]);
+    }
+    return static_cast<bool>(out);
+}
+
+/** map a file written by saveBinary, the arrays are used in place
+    verifyChecksum reads the whole file once to detect damage; without
+    it the offsets and vertex ids are still checked to stay in range,
+    so no query reads outside the file
+    return false if the file could not be read, is damaged or has
+    another version, the graph is then left unchanged */
+bool CsrGraph::loadBinary(const std::string& filename, bool verifyChecksum) {
+    auto file = std::make_shared<MappedFile>();
+    if (!file->open(filename) || file->size() < sizeof(BinaryHeader)) {
+        return false;
+    }
+    BinaryHeader header;
+    std::memcpy(&header, file->data(), sizeof(header));
+    if (std::memcmp(header.magic, kMagic, sizeof(kMagic)) != 0 ||
+        header.version != kVersion || header.byteOrder != kByteOrder ||
+        header.numVertices >= INT_MAX || header.numEdges >= INT_MAX ||
+        header.numLabelBytes > file->size()) {
+        return false;
+    }
+
+    std::uint64_t n = header.numVertices;
+    std::uint64_t m = header.numEdges;
+    const std::uint64_t sizes[] = {
+        (n + 1) * sizeof(std::uint64_t), header.numLabelBytes,
+        (n + 1) * sizeof(int), m * sizeof(int), m * sizeof(int),
+        (n + 1) * sizeof(int), m * sizeof(int), m * sizeof(int),
+        n * sizeof(int) };
+    const char* sections[kSections];
+    std::uint64_t at = sizeof(header);
+    for (int s = 0; s < kSections; ++s) {
+        sections[s] = file->data() + at;
+        at += padded(sizes[s]);
+    }
+    if (at != file->size()) return false;
+
+    if (verifyChecksum) {
+        std::uint64_t checksum = 14695981039346656037ULL;
+        for (int s = 0; s < kSections; ++s) {
+            checksum = mixSection(checksum, sections[s], sizes[s]);
+        }
+        if (checksum != header.checksum) return false;
+    }
+
+    // the checksum only catches accidents, so every index used by the
+    // queries is checked to stay inside its array, in O(n + m)
+    const std::uint64_t* fileLabelOffsets =
+        reinterpret_cast<const std::uint64_t*>(sections[0]);
+    const int* fileOffsets = reinterpret_cast<const int*>(sections[2]);
+    const int* fileInOffsets = reinterpret_cast<const int*>(sections[5]);
+    const int* fileLabelOrder = reinterpret_cast<const int*>(sections[8]);
+    if (fileLabelOffsets[0] != 0 ||
+        fileLabelOffsets[n] != header.numLabelBytes) {
+        return false;
+    }
+    for (std::uint64_t v = 0; v < n; ++v) {
+        if (fileLabelOffsets[v] > fileLabelOffsets[v + 1]) return false;
+    }
+    if (!validOffsets(fileOffsets, n, m) ||
+        !validOffsets(fileInOffsets, n, m) ||
+        !validIds(reinterpret_cast<const int*>(sections[3]), m, n) ||
+        !validIds(reinterpret_cast<const int*>(sections[6]), m, n) ||
+        !validIds(fileLabelOrder, n, n)) {
+        return false;
+    }
+    std::vector<char> ranked(n, 0);
+    for (std::uint64_t rank = 0; rank < n; ++rank) {
+        if (ranked[fileLabelOrder[rank]]++) return false;
+    }
+
+    numVertices = static_cast<int>(n);
+    numEdges = static_cast<int>(m);
+    labelOffsets = fileLabelOffsets;
+    labelBytes = sections[1];
+    offsets = fileOffsets;
+    targets = reinterpret_cast<const int*>(sections[3]);
+    weights = reinterpret_cast<const int*>(sections[4]);
+    inOffsets = fileInOffsets;
+    sources = reinterpret_cast<const int*>(sections[6]);
+    inWeights = reinterpret_cast<const int*>(sections[7]);
+    labelOrder = fileLabelOrder;
+    negativeWeights = (header.flags & 1) != 0;
+    storage = file;
+    return true;
+}
+
+/** depth-first traversal starting from startLabel
+    call the function visit on each vertex label
+    same visit order as Graph::depthFirstTraversal when the ids are
+    in label order */
+void CsrGraph::depthFirstTraversal(const std::string& startLabel,
+                                   void visit(const std::string&)) const {
+    int start = findVertex(startLabel);
+    if (start < 0) return;
+
+    std::vector<char> visited(numVertices, 0);
+    // each entry is a vertex and the next edge to look at
+    std::vector<std::pair<int, int>> stack;
+    visited[start] = 1;
+    visit(getLabel(start));
+    stack.push_back({ start, offsets[start] });
+
+    while (!stack.empty()) {
+        auto& top = stack.back();
+        if (top.second == offsets[top.first + 1]) {
+            stack.pop_back();
+            continue;
+        }
+        int next = targets[top.second++];
+        if (!visited[next]) {
+            visited[next] = 1;
+            visit(getLabel(next));
+            stack.push_back({ next, offsets[next] });
+        }
+    }
+}
+
+/** breadth-first traversal starting from startLabel
+    call the function visit on each vertex label
+    same visit order as Graph::breadthFirstTraversal when the ids
+    are in label order */
+void CsrGraph::breadthFirstTraversal(const std::string& startLabel,
+                                     void visit(const std::string&)) const {
+    int start = findVertex(startLabel);
+    if (start < 0) return;
+
+    std::vector<char> visited(numVertices, 0);
+    // vertices are never queued twice, so the queue is at most n long
+    std::vector<int> queue;
+    queue.reserve(numVertices);
+    visited[start] = 1;
+    visit(getLabel(start));
+    queue.push_back(start);
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        int v = queue[head];
+        for (int e = offsets[v]; e < offsets[v + 1]; ++e) {
+            int u = targets[e];
+            if (!visited[u]) {
+                visited[u] = 1;
+                visit(getLabel(u));
+                queue.push_back(u);
+            }
+        }
+    }
+}
+
+/** find the lowest cost from startLabel to all vertices that can be reached
+    same output format as Graph::djikstraCostToAllVertices */
+void CsrGraph::djikstraCostToAllVertices(
+    const std::string& startLabel,
+    std::map<std::string, int>& weight,
+    std::map<std::string, std::string>& previous) const {
+    weight.clear();
+    previous.clear();
+    int start = findVertex(startLabel);
+    if (start < 0) return;
+
+    DijkstraEngine engine;
+    engine.run(*this, start);
+    fillCostMaps(start, engine.getDistances(), engine.getPredecessors(),
+                 weight, previous);
+}
+
+/** convert id-indexed results of a search from start into the maps
+    of djikstraCostToAllVertices, start and unreachable vertices
+    are left out */
+void CsrGraph::fillCostMaps(int start, const std::vector<int>& distance,
+                            const std::vector<int>& predecessor,
+                            std::map<std::string, int>& weight,
+                            std::map<std::string, std::string>& previous) const {
+    weight.clear();
+    previous.clear();
+    int n = getNumVertices();
+    for (int v = 0; v < n; ++v) {
+        if (v == start || distance[v] == INT_MAX) continue;
+        std::string label = getLabel(v);
+        weight.insert(weight.end(), { label, distance[v] });
+        previous.insert(previous.end(),
+                        { label, getLabel(predecessor[v]) });
+    }
+}
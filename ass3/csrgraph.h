@@ -0,0 +1,185 @@
+/**
+ * An immutable, compact copy of a Graph in compressed-sparse-row form
+ * Vertices get dense integer ids 0..n-1, in alphabetical order of labels
+ * unless reorder renumbered them for locality; a sorted index of the
+ * labels finds vertices either way
+ * The outgoing edges of vertex v are stored at positions
+ * offsets[v] .. offsets[v+1]-1 of the targets and weights arrays,
+ * in order of target id, which is alphabetical order for label ids
+ * The incoming edges are kept the same way in a second set of arrays,
+ * for searches that run backwards from a target
+ * The labels are packed into one string table. All arrays are shared by
+ * copies of the graph and can live in a file written by saveBinary and
+ * mapped into memory by loadBinary, so loading needs no parsing
+ */
+
+#ifndef CSRGRAPH_H
+#define CSRGRAPH_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+/** numbering of the vertices of a CsrGraph, see CsrGraph::reorder */
+enum class VertexOrder {
+    /** alphabetical order of labels, as built by Graph::freeze */
+    Label,
+    /** breadth-first order, ignoring edge direction */
+    Bfs,
+    /** highest degree first, so the busiest vertices share cache lines */
+    Degree,
+    /** reverse Cuthill-McKee, keeps neighbors' ids close together */
+    ReverseCuthillMcKee
+};
+
+class CsrGraph {
+ public:
+    /** constructor, empty graph */
+    CsrGraph();
+
+    /** constructor from prebuilt arrays, vertex v gets labels[v]
+        offsets must have labels.size() + 1 entries
+        targets and weights must have offsets.back() entries
+        the incoming edge arrays are derived from them */
+    CsrGraph(std::vector<std::string> labels, std::vector<int> offsets,
+             std::vector<int> targets, std::vector<int> weights);
+
+    /** return number of vertices */
+    int getNumVertices() const;
+
+    /** return number of edges */
+    int getNumEdges() const;
+
+    /** return true if any edge has a negative weight */
+    bool hasNegativeWeights() const;
+
+    /** return a 64-bit hash of the labels, edges and weights
+        used to check that saved data belongs to this graph */
+    std::uint64_t fingerprint() const;
+
+    /** return the id of the vertex with the given label
+        returns -1 if the vertex does not exist */
+    int findVertex(const std::string& vertexLabel) const;
+
+    /** return the id of the vertex whose label comes at position rank
+        in alphabetical order */
+    int vertexByLabel(int rank) const { return labelOrder[rank]; }
+
+    /** return the label of vertex id */
+    std::string getLabel(int id) const {
+        return std::string(labelBytes + labelOffsets[id],
+                           labelBytes + labelOffsets[id + 1]);
+    }
+
+    /** first edge index of vertex id */
+    int edgeBegin(int id) const { return offsets[id]; }
+
+    /** one past the last edge index of vertex id */
+    int edgeEnd(int id) const { return offsets[id + 1]; }
+
+    /** vertex id the edge points to */
+    int edgeTarget(int edge) const { return targets[edge]; }
+
+    /** weight of the edge */
+    int edgeWeight(int edge) const { return weights[edge]; }
+
+    /** first incoming edge index of vertex id */
+    int inEdgeBegin(int id) const { return inOffsets[id]; }
+
+    /** one past the last incoming edge index of vertex id */
+    int inEdgeEnd(int id) const { return inOffsets[id + 1]; }
+
+    /** vertex id the incoming edge starts from */
+    int inEdgeSource(int inEdge) const { return sources[inEdge]; }
+
+    /** weight of the incoming edge */
+    int inEdgeWeight(int inEdge) const { return inWeights[inEdge]; }
+
+    /** return a copy with the vertices renumbered in the given order
+        labels, edges and weights are unchanged, only ids differ */
+    CsrGraph reorder(VertexOrder order) const;
+
+    /** return a copy in which vertex newId is vertex order[newId] of
+        this graph, order must hold every id once */
+    CsrGraph permute(const std::vector<int>& order) const;
+
+    /** write the graph to filename in a versioned, checksummed binary
+        format that loadBinary maps back
+        return false if the file could not be written */
+    bool saveBinary(const std::string& filename) const;
+
+    /** map a file written by saveBinary, the arrays are used in place
+        verifyChecksum reads the whole file once to detect damage; without
+        it the offsets and vertex ids are still checked to stay in range,
+        so no query reads outside the file
+        return false if the file could not be read, is damaged or has
+        another version, the graph is then left unchanged */
+    bool loadBinary(const std::string& filename, bool verifyChecksum = true);
+
+    /** depth-first traversal starting from startLabel
+        call the function visit on each vertex label
+        same visit order as Graph::depthFirstTraversal when the ids are
+        in label order */
+    void depthFirstTraversal(const std::string& startLabel,
+                             void visit(const std::string&)) const;
+
+    /** breadth-first traversal starting from startLabel
+        call the function visit on each vertex label
+        same visit order as Graph::breadthFirstTraversal when the ids
+        are in label order */
+    void breadthFirstTraversal(const std::string& startLabel,
+                               void visit(const std::string&)) const;
+
+    /** find the lowest cost from startLabel to all vertices that can be reached
+        same output format as Graph::djikstraCostToAllVertices */
+    void djikstraCostToAllVertices(
+        const std::string& startLabel,
+        std::map<std::string, int>& weight,
+        std::map<std::string, std::string>& previous) const;
+
+    /** convert id-indexed results of a search from start into the maps
+        of djikstraCostToAllVertices, start and unreachable vertices
+        are left out */
+    void fillCostMaps(int start, const std::vector<int>& distance,
+                      const std::vector<int>& predecessor,
+                      std::map<std::string, int>& weight,
+                      std::map<std::string, std::string>& previous) const;
+
+ private:
+    /** owner of the arrays below, shared by copies of the graph
+        either vectors built by the constructor or a mapped file */
+    std::shared_ptr<const void> storage;
+
+    int numVertices {0};
+    int numEdges {0};
+
+    /** label of vertex v is labelBytes[labelOffsets[v]] up to
+        labelBytes[labelOffsets[v + 1]] */
+    const char* labelBytes {nullptr};
+    const std::uint64_t* labelOffsets {nullptr};
+
+    /** every vertex id, in alphabetical order of labels */
+    const int* labelOrder {nullptr};
+
+    /** numVertices + 1 entries, edges of v are offsets[v]..offsets[v+1]-1 */
+    const int* offsets {nullptr};
+
+    /** end vertex id of each edge */
+    const int* targets {nullptr};
+
+    /** weight of each edge */
+    const int* weights {nullptr};
+
+    /** incoming edges, same layout as offsets, targets and weights
+        built from the outgoing edges on construction */
+    const int* inOffsets {nullptr};
+    const int* sources {nullptr};
+    const int* inWeights {nullptr};
+
+    /** true if any weight is negative, computed once on construction */
+    bool negativeWeights {false};
+};  // end CsrGraph
+
+#endif  // CSRGRAPH_H
@@ -0,0 +1,200 @@
+#include <climits>
+
+#include "deltastepping.h"
+#include "dijkstraengine.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/** pack a cost and predecessor so that comparing the words compares the
+    costs first and the predecessors on a tie */
+std::uint64_t pack(int cost, int pred) {
+    return (static_cast<std::uint64_t>(static_cast<unsigned>(cost)) << 32) |
+        static_cast<unsigned>(pred);
+}
+
+int costOf(std::uint64_t word) { return static_cast<int>(word >> 32); }
+
+int predOf(std::uint64_t word) {
+    return static_cast<int>(static_cast<unsigned>(word));
+}
+
+/** state of the source vertex */
+const std::uint64_t kSource = pack(0, -1);
+
+/** vertices per chunk handed to a thread */
+const int kGrain = 256;
+
+}  // namespace
+
+/** constructor, the loops run on pool
+    delta 0 picks a bucket width from the graph on each run */
+DeltaStepping::DeltaStepping(ThreadPool& pool, int delta)
+    : pool(pool), delta(delta), stamp(0) {}
+
+/** return the bucket width, 0 if it is picked per graph */
+int DeltaStepping::getDelta() const { return delta; }
+
+/** set the bucket width, 0 picks one per graph
+    a run raises a width of at most heaviest weight / n above that,
+    so it needs no more than n + 1 buckets */
+void DeltaStepping::setDelta(int delta) { this->delta = delta; }
+
+/** compute the lowest cost from source to every vertex of graph */
+void DeltaStepping::run(const CsrGraph& graph, int source) {
+    int n = graph.getNumVertices();
+    distance.assign(n, INT_MAX);
+    predecessor.assign(n, -1);
+    if (source < 0 || source >= n) return;
+
+    if (graph.hasNegativeWeights()) {
+        DijkstraEngine engine;
+        engine.run(graph, source);
+        distance = engine.getDistances();
+        predecessor = engine.getPredecessors();
+        return;
+    }
+
+    // pending costs span at most the heaviest edge, so that many
+    // buckets, used in a cycle, hold them all; a width too small for
+    // n buckets to cover that span is raised
+    int heaviest = 0;
+    for (int e = 0; e < graph.getNumEdges(); ++e) {
+        if (graph.edgeWeight(e) > heaviest) heaviest = graph.edgeWeight(e);
+    }
+    int width = delta > 0 ? delta : pickDelta(graph, heaviest);
+    if (width <= heaviest / n) width = heaviest / n + 1;
+    if (static_cast<int>(state.size()) != n) {
+        std::vector<std::atomic<std::uint64_t>> fresh(n);
+        state.swap(fresh);
+    }
+    for (int v = 0; v < n; ++v) {
+        state[v].store(pack(INT_MAX, -1), std::memory_order_relaxed);
+    }
+    marks.assign(n, 0);
+    stamp = 0;
+    for (std::vector<int>& bucket : buckets) {
+        bucket.clear();
+    }
+    buckets.resize(heaviest / width + 2);
+    pending = 0;
+    improved.assign(pool.getNumThreads(), std::vector<int>());
+
+    state[source].store(kSource, std::memory_order_relaxed);
+    buckets[0].push_back(source);
+    pending = 1;
+
+    std::vector<int> round;
+    std::vector<int> settled;
+    // b counts buckets, b % buckets.size() is where bucket b is kept
+    for (size_t b = 0; pending > 0; ++b) {
+        std::vector<int>& bucket = buckets[b % buckets.size()];
+        settled.clear();
+        while (!bucket.empty()) {
+            // each vertex that still belongs here, once per round
+            round.clear();
+            ++stamp;
+            for (int v : bucket) {
+                int cost = costOf(state[v].load(std::memory_order_relaxed));
+                if (static_cast<size_t>(cost / width) != b ||
+                    marks[v] == stamp) {
+                    continue;
+                }
+                marks[v] = stamp;
+                round.push_back(v);
+            }
+            pending -= bucket.size();
+            bucket.clear();
+            relax(graph, round, width, true);
+            settled.insert(settled.end(), round.begin(), round.end());
+            collect(width);
+        }
+
+        // costs in this bucket are final now, heavy edges leave it
+        round.clear();
+        ++stamp;
+        for (int v : settled) {
+            if (marks[v] != stamp) {
+                marks[v] = stamp;
+                round.push_back(v);
+            }
+        }
+        relax(graph, round, width, false);
+        collect(width);
+    }
+
+    for (int v = 0; v < n; ++v) {
+        std::uint64_t word = state[v].load(std::memory_order_relaxed);
+        distance[v] = costOf(word);
+        predecessor[v] = predOf(word);
+    }
+}
+
+/** cost from the last source, INT_MAX if unreachable */
+const std::vector<int>& DeltaStepping::getDistances() const {
+    return distance;
+}
+
+/** previous vertex on the shortest path, -1 if none */
+const std::vector<int>& DeltaStepping::getPredecessors() const {
+    return predecessor;
+}
+
+/** bucket width for graph when delta is 0, heaviest is its largest
+    edge weight */
+int DeltaStepping::pickDelta(const CsrGraph& graph, int heaviest) {
+    // the usual choice: heaviest edge over average degree
+    int n = graph.getNumVertices();
+    int degree = n > 0 ? graph.getNumEdges() / n : 1;
+    int width = heaviest / (degree > 0 ? degree : 1);
+    return width > 0 ? width : 1;
+}
+
+/** relax the light or heavy edges of the given vertices */
+void DeltaStepping::relax(const CsrGraph& graph, const std::vector<int>& from,
+                          int width, bool light) {
+    pool.parallelFor(0, static_cast<int>(from.size()), kGrain,
+        [&](int first, int last, int thread) {
+        std::vector<int>& mine = improved[thread];
+        for (int i = first; i < last; ++i) {
+            int v = from[i];
+            int cost = costOf(state[v].load(std::memory_order_relaxed));
+            for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+                int weight = graph.edgeWeight(e);
+                if ((weight <= width) != light) continue;
+                int u = graph.edgeTarget(e);
+                // in 64 bits, so a sum past INT_MAX counts as no path
+                std::int64_t through = std::int64_t(cost) + weight;
+                if (through >= INT_MAX) continue;
+                std::uint64_t wanted = pack(static_cast<int>(through), v);
+                std::uint64_t seen = state[u].load(std::memory_order_relaxed);
+                // the source keeps predecessor -1 even on a 0 cost cycle
+                while (wanted < seen && seen != kSource) {
+                    if (state[u].compare_exchange_weak(seen, wanted)) {
+                        // a new predecessor at equal cost needs no rerun
+                        if (costOf(wanted) < costOf(seen)) {
+                            mine.push_back(u);
+                        }
+                        break;
+                    }
+                }
+            }
+        }
+    });
+}
+
+/** move the vertices improved in the last round into buckets */
+void DeltaStepping::collect(int width) {
+    for (std::vector<int>& mine : improved) {
+        for (int u : mine) {
+            int cost = costOf(state[u].load(std::memory_order_relaxed));
+            size_t b = static_cast<size_t>(cost / width);
+            buckets[b % buckets.size()].push_back(u);
+            ++pending;
+        }
+        mine.clear();
+    }
+}
@@ -0,0 +1,88 @@
+/**
+ * Parallel single-source shortest paths by delta-stepping
+ * Vertices are kept in buckets of width delta by tentative cost. The
+ * lowest bucket is emptied repeatedly, relaxing light edges (weight at
+ * most delta) of all its vertices in parallel, since they may put
+ * vertices back into the same bucket; then the heavy edges of everything
+ * that was in the bucket are relaxed once, also in parallel
+ * Pending costs never span more than the heaviest edge, so the buckets
+ * are reused in a cycle and number at most about n
+ * Costs and predecessors are updated together with one atomic
+ * compare-and-swap on a packed (cost, predecessor) word. When two
+ * shortest paths tie, the smaller predecessor id wins, so the result
+ * does not depend on the number of threads or their timing
+ * Edge weights must not be negative, if there are any the sequential
+ * DijkstraEngine is used instead
+ */
+
+#ifndef DELTASTEPPING_H
+#define DELTASTEPPING_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "csrgraph.h"
+#include "threadpool.h"
+
+class DeltaStepping {
+ public:
+    /** constructor, the loops run on pool
+        delta 0 picks a bucket width from the graph on each run */
+    explicit DeltaStepping(ThreadPool& pool, int delta = 0);
+
+    /** return the bucket width, 0 if it is picked per graph */
+    int getDelta() const;
+
+    /** set the bucket width, 0 picks one per graph
+        a run raises a width of at most heaviest weight / n above that,
+        so it needs no more than n + 1 buckets */
+    void setDelta(int delta);
+
+    /** compute the lowest cost from source to every vertex of graph */
+    void run(const CsrGraph& graph, int source);
+
+    /** cost from the last source, INT_MAX if unreachable */
+    const std::vector<int>& getDistances() const;
+
+    /** previous vertex on the shortest path, -1 if none */
+    const std::vector<int>& getPredecessors() const;
+
+ private:
+    ThreadPool& pool;
+    int delta;
+
+    /** cost in the high half, predecessor in the low half */
+    std::vector<std::atomic<std::uint64_t>> state;
+
+    /** round stamp of each vertex, used to drop duplicate entries */
+    std::vector<unsigned> marks;
+    unsigned stamp;
+
+    /** lazy buckets, an entry is stale if its vertex has moved lower
+        used in a cycle: bucket b is kept at b % buckets.size() */
+    std::vector<std::vector<int>> buckets;
+
+    /** entries in all buckets, stale ones included */
+    size_t pending {0};
+
+    /** vertices improved by each thread in the current round */
+    std::vector<std::vector<int>> improved;
+
+    /** result arrays of the last run */
+    std::vector<int> distance;
+    std::vector<int> predecessor;
+
+    /** bucket width for graph when delta is 0, heaviest is its largest
+        edge weight */
+    static int pickDelta(const CsrGraph& graph, int heaviest);
+
+    /** relax the light or heavy edges of the given vertices */
+    void relax(const CsrGraph& graph, const std::vector<int>& from,
+               int width, bool light);
+
+    /** move the vertices improved in the last round into buckets */
+    void collect(int width);
+};  // end DeltaStepping
+
+#endif  // DELTASTEPPING_H
@@ -0,0 +1,175 @@
+#include <climits>
+#include <cstdint>
+#include <utility>
+
+#include "dijkstraengine.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+/** constructor, 4-ary heap unless told otherwise */
+DijkstraEngine::DijkstraEngine(HeapType heapType) : heapType(heapType) {}
+
+/** return the heap used by run */
+HeapType DijkstraEngine::getHeapType() const { return heapType; }
+
+/** choose the heap used by run */
+void DijkstraEngine::setHeapType(HeapType heapType) {
+    this->heapType = heapType;
+}
+
+/** compute the lowest cost from source to every vertex of graph
+    a graph with negative weights is searched by Bellman-Ford instead
+    return false on a negative cycle, every cost is then INT_MAX */
+bool DijkstraEngine::run(const CsrGraph& graph, int source) {
+    return dispatch<false>(graph, source);
+}
+
+/** compute the lowest cost from every vertex of graph to target
+    follows incoming edges, so predecessor[v] is the next vertex
+    after v on its shortest path to target
+    return false on a negative cycle, every cost is then INT_MAX */
+bool DijkstraEngine::runReverse(const CsrGraph& graph, int target) {
+    return dispatch<true>(graph, target);
+}
+
+/** cost from the last source, INT_MAX if unreachable */
+const std::vector<int>& DijkstraEngine::getDistances() const {
+    return distance;
+}
+
+/** previous vertex on the shortest path, -1 if none */
+const std::vector<int>& DijkstraEngine::getPredecessors() const {
+    return predecessor;
+}
+
+/** move the arrays of the last run into distances and predecessors,
+    the engine allocates new ones on its next run */
+void DijkstraEngine::takeResults(std::vector<int>& distances,
+                                 std::vector<int>& predecessors) {
+    distances = std::move(distance);
+    predecessors = std::move(predecessor);
+    distance.clear();
+    predecessor.clear();
+}
+
+/** work done by the last run, all zero unless kStatsEnabled */
+const QueryStats& DijkstraEngine::getStats() const { return stats; }
+
+/** pick the heap and run the algorithm */
+template <bool Reverse>
+bool DijkstraEngine::dispatch(const CsrGraph& graph, int source) {
+    int n = graph.getNumVertices();
+    distance.assign(n, INT_MAX);
+    predecessor.assign(n, -1);
+    if (kStatsEnabled) {
+        stats = QueryStats();
+        heapState.assign(n, 0);
+    }
+    if (source < 0 || source >= n) return true;
+    if (graph.hasNegativeWeights()) return bellmanFord<Reverse>(graph, source);
+
+    switch (heapType) {
+    case HeapType::Binary:
+        runWith<Reverse>(binaryHeap, graph, source);
+        break;
+    case HeapType::Pairing:
+        runWith<Reverse>(pairingHeap, graph, source);
+        break;
+    case HeapType::Radix:
+        runWith<Reverse>(radixHeap, graph, source);
+        break;
+    default:
+        runWith<Reverse>(fourAryHeap, graph, source);
+        break;
+    }
+    return true;
+}
+
+/** the algorithm, specialized for each heap and direction */
+template <bool Reverse, class Heap>
+void DijkstraEngine::runWith(Heap& heap, const CsrGraph& graph,
+                             int source) {
+    heap.reserve(graph.getNumVertices());
+    distance[source] = 0;
+    heap.update(source, 0);
+    long long frontier = 0;
+    if (kStatsEnabled) countPush(source, frontier);
+
+    while (!heap.empty()) {
+        int v = heap.pop();
+        if (kStatsEnabled) {
+            stats.heapPops++;
+            stats.verticesSettled++;
+            if (heapState[v] == 2) stats.stalePops++;
+            heapState[v] = 2;
+            --frontier;
+        }
+        int cost = distance[v];
+        int first = Reverse ? graph.inEdgeBegin(v) : graph.edgeBegin(v);
+        int last = Reverse ? graph.inEdgeEnd(v) : graph.edgeEnd(v);
+        if (kStatsEnabled) stats.edgesRelaxed += last - first;
+        for (int e = first; e < last; ++e) {
+            int u = Reverse ? graph.inEdgeSource(e) : graph.edgeTarget(e);
+            // in 64 bits, so a sum past INT_MAX counts as no path
+            std::int64_t through = std::int64_t(cost) +
+                (Reverse ? graph.inEdgeWeight(e) : graph.edgeWeight(e));
+            if (through < distance[u]) {
+                distance[u] = static_cast<int>(through);
+                predecessor[u] = v;
+                heap.update(u, distance[u]);
+                if (kStatsEnabled) countPush(u, frontier);
+            }
+        }
+    }
+}
+
+/** Bellman-Ford for graphs with negative weights, in 64-bit costs
+    a shortest path has at most n - 1 edges, so a change in round n
+    means a negative cycle; costs past INT_MAX count as no path and
+    costs below INT_MIN are reported as INT_MIN */
+template <bool Reverse>
+bool DijkstraEngine::bellmanFord(const CsrGraph& graph, int source) {
+    int n = graph.getNumVertices();
+    std::vector<std::int64_t> cost(n, INT_MAX);
+    cost[source] = 0;
+    for (int round = 1; round <= n; ++round) {
+        bool changed = false;
+        for (int v = 0; v < n; ++v) {
+            if (cost[v] == INT_MAX) continue;
+            int first = Reverse ? graph.inEdgeBegin(v) : graph.edgeBegin(v);
+            int last = Reverse ? graph.inEdgeEnd(v) : graph.edgeEnd(v);
+            if (kStatsEnabled) stats.edgesRelaxed += last - first;
+            for (int e = first; e < last; ++e) {
+                int u = Reverse ? graph.inEdgeSource(e) : graph.edgeTarget(e);
+                std::int64_t through = cost[v] +
+                    (Reverse ? graph.inEdgeWeight(e) : graph.edgeWeight(e));
+                if (through < cost[u]) {
+                    cost[u] = through;
+                    predecessor[u] = v;
+                    changed = true;
+                }
+            }
+        }
+        if (!changed) {
+            for (int v = 0; v < n; ++v) {
+                distance[v] = static_cast<int>(
+                    cost[v] < INT_MIN ? INT_MIN : cost[v]);
+            }
+            // the source is reached by no edge, even on a 0 cycle
+            predecessor[source] = -1;
+            return true;
+        }
+    }
+    predecessor.assign(n, -1);
+    return false;
+}
+
+/** count vertex v going into the heap, unless it is already queued */
+void DijkstraEngine::countPush(int v, long long& frontier) {
+    if (heapState[v] == 1) return;
+    heapState[v] = 1;
+    stats.heapPushes++;
+    if (++frontier > stats.peakFrontier) stats.peakFrontier = frontier;
+}
@@ -0,0 +1,98 @@
+/**
+ * Single-source shortest paths on a CsrGraph using Dijkstra's algorithm
+ * Works on integer vertex ids and returns flat arrays:
+ * distance[v] is the cost from the source, INT_MAX if unreachable
+ * predecessor[v] is the vertex before v on a shortest path, -1 for the
+ * source and for unreachable vertices
+ * Graphs with negative weights are searched by Bellman-Ford, which
+ * reports a negative cycle instead of running forever
+ * An engine keeps its heap and arrays between runs, so reusing one
+ * engine for many queries avoids reallocating them
+ * An engine is not thread safe, use one engine per thread
+ */
+
+#ifndef DIJKSTRAENGINE_H
+#define DIJKSTRAENGINE_H
+
+#include <vector>
+
+#include "csrgraph.h"
+#include "priorityqueues.h"
+#include "querystats.h"
+
+/** priority queue used by the engine */
+enum class HeapType { Binary, FourAry, Pairing, Radix };
+
+class DijkstraEngine {
+ public:
+    /** constructor, 4-ary heap unless told otherwise */
+    explicit DijkstraEngine(HeapType heapType = HeapType::FourAry);
+
+    /** return the heap used by run */
+    HeapType getHeapType() const;
+
+    /** choose the heap used by run */
+    void setHeapType(HeapType heapType);
+
+    /** compute the lowest cost from source to every vertex of graph
+        a graph with negative weights is searched by Bellman-Ford instead
+        return false on a negative cycle, every cost is then INT_MAX */
+    bool run(const CsrGraph& graph, int source);
+
+    /** compute the lowest cost from every vertex of graph to target
+        follows incoming edges, so predecessor[v] is the next vertex
+        after v on its shortest path to target
+        return false on a negative cycle, every cost is then INT_MAX */
+    bool runReverse(const CsrGraph& graph, int target);
+
+    /** cost from the last source, INT_MAX if unreachable */
+    const std::vector<int>& getDistances() const;
+
+    /** previous vertex on the shortest path, -1 if none */
+    const std::vector<int>& getPredecessors() const;
+
+    /** move the arrays of the last run into distances and predecessors,
+        the engine allocates new ones on its next run */
+    void takeResults(std::vector<int>& distances,
+                     std::vector<int>& predecessors);
+
+    /** work done by the last run, all zero unless kStatsEnabled */
+    const QueryStats& getStats() const;
+
+ private:
+    /** heap used by run */
+    HeapType heapType;
+
+    /** result arrays of the last run */
+    std::vector<int> distance;
+    std::vector<int> predecessor;
+
+    /** counters of the last run and, while counting, whether each
+        vertex is unseen (0), queued (1) or settled (2) */
+    QueryStats stats;
+    std::vector<char> heapState;
+
+    /** one of each heap, kept so their memory is reused */
+    IndexedDaryHeap<2> binaryHeap;
+    IndexedDaryHeap<4> fourAryHeap;
+    PairingHeap pairingHeap;
+    RadixHeap radixHeap;
+
+    /** pick the heap and run the algorithm */
+    template <bool Reverse>
+    bool dispatch(const CsrGraph& graph, int source);
+
+    /** Bellman-Ford for graphs with negative weights, in 64-bit costs
+        return false on a negative cycle */
+    template <bool Reverse>
+    bool bellmanFord(const CsrGraph& graph, int source);
+
+    /** count vertex v going into the heap, unless it is already queued */
+    void countPush(int v, long long& frontier);
+
+    /** the algorithm, specialized for each heap and direction */
+    template <bool Reverse, class Heap>
+    void runWith(Heap& heap, const CsrGraph& graph, int source);
+};  // end DijkstraEngine
+
+#endif  // DIJKSTRAENGINE_H
@@ -0,0 +1,123 @@
+#include <algorithm>
+#include <climits>
+#include <utility>
+
+#include "dijkstraengine.h"
+#include "distancematrix.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+/** constructor, no sources */
+DistanceMatrix::DistanceMatrix() : withPredecessors(false) {}
+
+/** matrix for the given source ids of graph, not computed yet
+    ids outside the graph give rows of INT_MAX */
+DistanceMatrix::DistanceMatrix(std::shared_ptr<const CsrGraph> graph,
+                               std::vector<int> sources,
+                               bool withPredecessors)
+    : graph(std::move(graph)), sources(std::move(sources)),
+      withPredecessors(withPredecessors) {
+    int n = getNumVertices();
+    rowOf.assign(n, -1);
+    for (int r = 0; r < getNumSources(); ++r) {
+        int& source = this->sources[r];
+        if (source < 0 || source >= n) {
+            source = -1;
+        } else if (rowOf[source] < 0) {
+            rowOf[source] = r;
+        }
+    }
+    size_t cells = static_cast<size_t>(getNumSources()) * n;
+    costs.assign(cells, INT_MAX);
+    if (withPredecessors) predecessors.assign(cells, -1);
+}
+
+/** run Dijkstra from every source on pool */
+void DistanceMatrix::compute(ThreadPool& pool) {
+    if (!graph) return;
+    size_t n = static_cast<size_t>(getNumVertices());
+    std::vector<DijkstraEngine> engines(pool.getNumThreads());
+    pool.parallelFor(0, getNumSources(), 1,
+        [&](int first, int last, int thread) {
+        DijkstraEngine& engine = engines[thread];
+        for (int r = first; r < last; ++r) {
+            if (sources[r] < 0) continue;
+            engine.run(*graph, sources[r]);
+            std::copy(engine.getDistances().begin(),
+                      engine.getDistances().end(), costs.begin() + r * n);
+            if (withPredecessors) {
+                std::copy(engine.getPredecessors().begin(),
+                          engine.getPredecessors().end(),
+                          predecessors.begin() + r * n);
+            }
+        }
+    });
+}
+
+/** return number of rows */
+int DistanceMatrix::getNumSources() const {
+    return static_cast<int>(sources.size());
+}
+
+/** return number of columns */
+int DistanceMatrix::getNumVertices() const {
+    return graph ? graph->getNumVertices() : 0;
+}
+
+/** return the source vertex id of row, -1 if it was not in the graph */
+int DistanceMatrix::getSource(int row) const { return sources[row]; }
+
+/** return the row of source id, -1 if it is not a source */
+int DistanceMatrix::findRow(int sourceId) const {
+    if (sourceId < 0 || sourceId >= getNumVertices()) return -1;
+    return rowOf[sourceId];
+}
+
+/** costs from the source of row, indexed by vertex id */
+const int* DistanceMatrix::row(int row) const {
+    return costs.data() + static_cast<size_t>(row) * getNumVertices();
+}
+
+/** cost from the source of row to vertex id */
+int DistanceMatrix::cost(int row, int vertex) const {
+    return this->row(row)[vertex];
+}
+
+/** cost between two labels, INT_MAX if start is not a source or end
+    cannot be reached */
+int DistanceMatrix::cost(const std::string& start,
+                         const std::string& end) const {
+    if (!graph) return INT_MAX;
+    int r = findRow(graph->findVertex(start));
+    int target = graph->findVertex(end);
+    if (r < 0 || target < 0) return INT_MAX;
+    return cost(r, target);
+}
+
+/** return true if predecessor trees were kept */
+bool DistanceMatrix::hasPredecessors() const { return withPredecessors; }
+
+/** vertex before vertex id on the path from the source of row
+    -1 for the source, unreachable vertices, or without trees */
+int DistanceMatrix::predecessor(int row, int vertex) const {
+    if (!withPredecessors) return -1;
+    return predecessors[static_cast<size_t>(row) * getNumVertices() + vertex];
+}
+
+/** labels on the shortest path from start to end, start first
+    empty if it cannot be rebuilt */
+std::vector<std::string> DistanceMatrix::path(const std::string& start,
+                                              const std::string& end) const {
+    std::vector<std::string> labels;
+    if (!graph || !withPredecessors) return labels;
+    int r = findRow(graph->findVertex(start));
+    int target = graph->findVertex(end);
+    if (r < 0 || target < 0 || cost(r, target) == INT_MAX) return labels;
+    for (int v = target; v >= 0; v = predecessor(r, v)) {
+        labels.push_back(graph->getLabel(v));
+    }
+    std::reverse(labels.begin(), labels.end());
+    return labels;
+}
@@ -0,0 +1,87 @@
+/**
+ * Shortest-path costs from many sources to every vertex of a CsrGraph
+ * Stored row-major in one block, row r holds the costs from source r
+ * indexed by vertex id, INT_MAX where the vertex cannot be reached
+ * Optionally the predecessor trees are kept in a second block of the
+ * same shape, so paths can be rebuilt
+ * compute spreads the sources over a ThreadPool, each thread reusing one
+ * DijkstraEngine for all the sources it gets
+ */
+
+#ifndef DISTANCEMATRIX_H
+#define DISTANCEMATRIX_H
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "csrgraph.h"
+#include "threadpool.h"
+
+class DistanceMatrix {
+ public:
+    /** constructor, no sources */
+    DistanceMatrix();
+
+    /** matrix for the given source ids of graph, not computed yet
+        ids outside the graph give rows of INT_MAX */
+    DistanceMatrix(std::shared_ptr<const CsrGraph> graph,
+                   std::vector<int> sources, bool withPredecessors);
+
+    /** run Dijkstra from every source on pool */
+    void compute(ThreadPool& pool);
+
+    /** return number of rows */
+    int getNumSources() const;
+
+    /** return number of columns */
+    int getNumVertices() const;
+
+    /** return the source vertex id of row, -1 if it was not in the graph */
+    int getSource(int row) const;
+
+    /** return the row of source id, -1 if it is not a source */
+    int findRow(int sourceId) const;
+
+    /** costs from the source of row, indexed by vertex id */
+    const int* row(int row) const;
+
+    /** cost from the source of row to vertex id */
+    int cost(int row, int vertex) const;
+
+    /** cost between two labels, INT_MAX if start is not a source or end
+        cannot be reached */
+    int cost(const std::string& start, const std::string& end) const;
+
+    /** return true if predecessor trees were kept */
+    bool hasPredecessors() const;
+
+    /** vertex before vertex id on the path from the source of row
+        -1 for the source, unreachable vertices, or without trees */
+    int predecessor(int row, int vertex) const;
+
+    /** labels on the shortest path from start to end, start first
+        empty if it cannot be rebuilt */
+    std::vector<std::string> path(const std::string& start,
+                                  const std::string& end) const;
+
+ private:
+    /** graph the costs belong to */
+    std::shared_ptr<const CsrGraph> graph;
+
+    /** source id of each row */
+    std::vector<int> sources;
+
+    /** row of each vertex id, -1 if it is not a source */
+    std::vector<int> rowOf;
+
+    /** numSources * numVertices costs */
+    std::vector<int> costs;
+
+    /** same shape as costs, empty without trees */
+    std::vector<int> predecessors;
+
+    bool withPredecessors;
+};  // end DistanceMatrix
+
+#endif  // DISTANCEMATRIX_H
@@ -0,0 +1,132 @@
+#include <climits>
+#include <cstddef>
+
+#include "dynamicsssp.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+/** shortest paths from source in graph, computed right away */
+DynamicSssp::DynamicSssp(const IdAdjacency& graph, int source)
+    : graph(graph), source(source), stamp(0), lastUpdateSize(0) {
+    recompute();
+}
+
+/** return the source vertex id */
+int DynamicSssp::getSource() const { return source; }
+
+/** recompute everything from scratch */
+void DynamicSssp::recompute() {
+    int n = graph.getNumVertices();
+    distance.assign(n, INT_MAX);
+    predecessor.assign(n, -1);
+    marks.assign(n, 0);
+    heap.reserve(n);
+    distance[source] = 0;
+    heap.update(source, 0);
+    lastUpdateSize = settle(false);
+}
+
+/** the edge from -> to was added, or its weight lowered, to weight */
+void DynamicSssp::edgeLowered(int from, int to, int weight) {
+    grow();
+    lastUpdateSize = 0;
+    if (distance[from] == INT_MAX || distance[from] + weight >= distance[to]) {
+        return;
+    }
+    distance[to] = distance[from] + weight;
+    predecessor[to] = from;
+    heap.update(to, distance[to]);
+    lastUpdateSize = settle(false);
+}
+
+/** the edge from -> to was removed, or its weight raised */
+void DynamicSssp::edgeRaised(int from, int to) {
+    grow();
+    lastUpdateSize = 0;
+    // only a tree edge can change any cost
+    if (predecessor[to] != from) return;
+
+    // the subtree below the edge, found through the tree's own edges
+    ++stamp;
+    affected.clear();
+    affected.push_back(to);
+    marks[to] = stamp;
+    for (size_t i = 0; i < affected.size(); ++i) {
+        int v = affected[i];
+        for (const IdAdjacency::Arc& arc : graph.outArcs(v)) {
+            int u = arc.vertex;
+            if (predecessor[u] == v && marks[u] != stamp) {
+                marks[u] = stamp;
+                affected.push_back(u);
+            }
+        }
+    }
+    for (int v : affected) {
+        distance[v] = INT_MAX;
+        predecessor[v] = -1;
+    }
+
+    // best way into the subtree from the vertices whose costs stand
+    for (int v : affected) {
+        for (const IdAdjacency::Arc& arc : graph.inArcs(v)) {
+            int p = arc.vertex;
+            if (marks[p] == stamp || distance[p] == INT_MAX) continue;
+            if (distance[p] + arc.weight < distance[v]) {
+                distance[v] = distance[p] + arc.weight;
+                predecessor[v] = p;
+            }
+        }
+        if (distance[v] != INT_MAX) heap.update(v, distance[v]);
+    }
+    settle(true);
+    lastUpdateSize = static_cast<int>(affected.size());
+}
+
+/** cost from the source to vertex id, INT_MAX if unreachable */
+int DynamicSssp::getDistance(int id) const {
+    // vertices added since the last update cannot be reached yet
+    return id < static_cast<int>(distance.size()) ? distance[id] : INT_MAX;
+}
+
+/** vertex before id on its shortest path, -1 for the source and
+    unreachable vertices */
+int DynamicSssp::getPredecessor(int id) const {
+    return id < static_cast<int>(predecessor.size()) ? predecessor[id] : -1;
+}
+
+/** number of vertices the last update looked at */
+int DynamicSssp::getLastUpdateSize() const { return lastUpdateSize; }
+
+/** make room for vertices added to graph since the last call */
+void DynamicSssp::grow() {
+    int n = graph.getNumVertices();
+    if (static_cast<int>(distance.size()) < n) {
+        distance.resize(n, INT_MAX);
+        predecessor.resize(n, -1);
+        marks.resize(n, 0);
+        heap.reserve(n);
+    }
+}
+
+/** settle the queued vertices, only lowering vertices in the current
+    affected set if onlyAffected, return how many were settled */
+int DynamicSssp::settle(bool onlyAffected) {
+    int settled = 0;
+    while (!heap.empty()) {
+        int v = heap.pop();
+        ++settled;
+        for (const IdAdjacency::Arc& arc : graph.outArcs(v)) {
+            int u = arc.vertex;
+            if (onlyAffected && marks[u] != stamp) continue;
+            int cost = distance[v] + arc.weight;
+            if (cost < distance[u]) {
+                distance[u] = cost;
+                predecessor[u] = v;
+                heap.update(u, cost);
+            }
+        }
+    }
+    return settled;
+}
@@ -0,0 +1,76 @@
+/**
+ * Single-source shortest paths kept up to date while the graph changes
+ * After a full Dijkstra run, each edge change repairs only the part of
+ * the shortest path tree it affects, in the style of Ramalingam and Reps:
+ * - a new or cheaper edge starts a Dijkstra search from its end vertex
+ *   that only follows vertices whose cost goes down
+ * - a removed or dearer tree edge cuts off the subtree below it; every
+ *   vertex of the subtree gets its best cost over incoming edges from
+ *   outside it, then Dijkstra runs inside the subtree only
+ * Edges that are not in the tree and do not get cheaper cost nothing
+ * The graph is read through an IdAdjacency that the owner updates before
+ * telling the structure about the change; weights must not be negative
+ */
+
+#ifndef DYNAMICSSSP_H
+#define DYNAMICSSSP_H
+
+#include <vector>
+
+#include "idadjacency.h"
+#include "priorityqueues.h"
+
+class DynamicSssp {
+ public:
+    /** shortest paths from source in graph, computed right away */
+    DynamicSssp(const IdAdjacency& graph, int source);
+
+    /** return the source vertex id */
+    int getSource() const;
+
+    /** recompute everything from scratch */
+    void recompute();
+
+    /** the edge from -> to was added, or its weight lowered, to weight */
+    void edgeLowered(int from, int to, int weight);
+
+    /** the edge from -> to was removed, or its weight raised */
+    void edgeRaised(int from, int to);
+
+    /** cost from the source to vertex id, INT_MAX if unreachable */
+    int getDistance(int id) const;
+
+    /** vertex before id on its shortest path, -1 for the source and
+        unreachable vertices */
+    int getPredecessor(int id) const;
+
+    /** number of vertices the last update looked at */
+    int getLastUpdateSize() const;
+
+ private:
+    const IdAdjacency& graph;
+    int source;
+
+    std::vector<int> distance;
+    std::vector<int> predecessor;
+
+    IndexedDaryHeap<4> heap;
+
+    /** stamp of the update that put each vertex in affected */
+    std::vector<unsigned> marks;
+    unsigned stamp;
+
+    /** subtree cut off by edgeRaised */
+    std::vector<int> affected;
+
+    int lastUpdateSize;
+
+    /** make room for vertices added to graph since the last call */
+    void grow();
+
+    /** settle the queued vertices, only lowering vertices in the current
+        affected set if onlyAffected, return how many were settled */
+    int settle(bool onlyAffected);
+};  // end DynamicSssp
+
+#endif  // DYNAMICSSSP_H
@@ -8,16 +8,25 @@
 ////////////////////////////////////////////////////////////////////////////////
 
 
-Edge::Edge() {}
+namespace {
 
-/** constructor with label and weight */
+/** end vertex of an empty edge */
+const std::string kNoVertex;
+
+}  // namespace
+
+/** empty edge constructor */
+Edge::Edge() : endVertex(&kNoVertex) {}
+
+/** constructor with label and weight
+    end must outlive the edge */
 Edge::Edge(const std::string& end, int weight) {
-	this->endVertex = end;
+	this->endVertex = &end;
 	this->edgeWeight = weight;
 }
 
 /** return the vertex this edge connects to */
-std::string Edge::getEndVertex() const { return endVertex; }
+const std::string& Edge::getEndVertex() const { return *endVertex; }
 
 /** return the weight/cost of travlleing via this edge */
 int Edge::getWeight() const { return edgeWeight; }
@@ -2,6 +2,8 @@
  * Used by vertex to keep track of all the vertices connects to
  * Each edge has a weight, possibly 0
  * Edge is a simple container class, no interesting functions
+ * The end label is not copied, the edge points at a label owned by
+ * someone else, normally the key of the edge in Vertex's adjacency map
  */
 
 #ifndef EDGE_H
@@ -14,18 +16,22 @@ class Edge {
     /** empty edge constructor */
     Edge();
 
-    /** constructor with label and weight */
+    /** constructor with label and weight
+        end must outlive the edge */
     Edge(const std::string& end, int weight);
 
+    /** a temporary label would be gone before the edge, so none is taken */
+    Edge(std::string&& end, int weight) = delete;
+
     /** return the vertex this edge connects to */
-    std::string getEndVertex() const;
+    const std::string& getEndVertex() const;
 
     /** return the weight/cost of travlleing via this edge */
     int getWeight() const;
 
  private:
     /** end vertex, cannot be changed */
-    std::string endVertex {""};
+    const std::string* endVertex;
 
     /** edge weight, cannot be changed */
     int edgeWeight {0};
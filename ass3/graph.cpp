@@ -1,11 +1,19 @@
-#include <queue>
+#include <algorithm>
 #include <climits>
-#include <set>
+#include <cstddef>
 #include <iostream>
-#include <fstream>
 #include <map>
-#include <list>
+#include <new>
+#include <utility>
+#include <vector>
+#include "altsearch.h"
+#include "bidirectionaldijkstra.h"
+#include "chsearch.h"
+#include "deltastepping.h"
+#include "dijkstraengine.h"
 #include "graph.h"
+#include "mappedfile.h"
+#include "parallelbfs.h"
 
 /**
  * A graph is made up of vertices and edges
@@ -17,25 +25,97 @@
  // This is 80 characters - Keep all lines under 80 characters                 //
  ////////////////////////////////////////////////////////////////////////////////
 
+namespace {
+
+/** files at least this large are parsed by several threads */
+const std::ptrdiff_t kParallelBytes = 1 << 20;
+
+bool isSpace(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' ||
+        c == '\f';
+}
+
+/** find the next whitespace separated token at or after at
+    return false if there is none before stop */
+bool nextToken(const char*& at, const char* stop, const char*& token,
+               int& length) {
+    while (at < stop && isSpace(*at)) ++at;
+    if (at == stop) return false;
+    token = at;
+    while (at < stop && !isSpace(*at)) ++at;
+    length = static_cast<int>(at - token);
+    return true;
+}
+
+/** read an optionally signed decimal int that fills the whole token
+    return false if it is not a number or does not fit */
+bool parseInt(const char* token, int length, int& value) {
+    const char* at = token;
+    const char* stop = token + length;
+    bool negative = false;
+    if (*at == '-' || *at == '+') {
+        negative = *at == '-';
+        ++at;
+    }
+    if (at == stop) return false;
+    long long result = 0;
+    for (; at < stop; ++at) {
+        if (*at < '0' || *at > '9') return false;
+        result = result * 10 + (*at - '0');
+        if (result > 2147483648LL) return false;
+    }
+    if (negative) result = -result;
+    if (result > INT_MAX) return false;
+    value = static_cast<int>(result);
+    return true;
+}
+
+/** read the edge count at the top of a graph file, at moves past it */
+bool parseHeader(const char*& at, const char* stop, int& expectedEdges) {
+    const char* token;
+    int length;
+    return nextToken(at, stop, token, length) &&
+        parseInt(token, length, expectedEdges);
+}
+
+/** read "start end weight" records from at up to stop into edges
+    return false if a record is cut short or its weight is not a number */
+bool parseEdges(const char* at, const char* stop,
+                std::vector<EdgeRecord>& edges) {
+    const char* start;
+    const char* end;
+    const char* token;
+    int startLength, endLength, length, weight;
+    while (nextToken(at, stop, start, startLength)) {
+        if (!nextToken(at, stop, end, endLength) ||
+            !nextToken(at, stop, token, length) ||
+            !parseInt(token, length, weight)) {
+            return false;
+        }
+        edges.push_back({ std::string(start, startLength),
+                          std::string(end, endLength), weight });
+    }
+    return true;
+}
+
+}  // namespace
+
 
  /** constructor, empty graph */
-Graph::Graph() {
+Graph::Graph() : vertices(decltype(vertices)::allocator_type(&pool)) {
     numberOfEdges = 0;
     numberOfVertices = 0;
+    verbose = false;
+    vertexOrder = VertexOrder::Label;
+    statsHook = nullptr;
+    version = 0;
 }
 
 /** destructor, delete all vertices and edges
     only vertices stored in map
-    no pointers to edges created by graph */
-Graph::~Graph() {
-
-    std::map<std::string, Vertex*>::iterator it;
-    for (it = vertices.begin(); it != vertices.end(); it++)
-    {
-        delete it->second;
-        it->second = nullptr;
-    }
-}
+    no pointers to edges created by graph
+    the pool then releases all of their memory at once */
+Graph::~Graph() { destroyVertices(); }
 
 /** return number of vertices */
 int Graph::getNumVertices() const { return this->numberOfVertices; }
@@ -49,30 +129,139 @@ int Graph::getNumEdges() const { return this->numberOfEdges; }
     a vertex cannot connect to itself
     or have multiple edges to another vertex */
 bool Graph::add(std::string start, std::string end, int edgeWeight) {
-    std::cout << start + " " + end + " " + std::to_string(edgeWeight) <<
-        std::endl;
-    auto it = vertices.find(start);
+    QueryStats stats;
+    StatsScope scope("add", statsHook, stats);
+    if (verbose) {
+        std::cout << start << ' ' << end << ' ' << edgeWeight << '\n';
+    }
+    if (!insertEdge(start, end, edgeWeight)) return false;
+    invalidateSnapshot(&start);
+    return true;
+}
 
-    if (it == vertices.end() || it->second->connect(end, edgeWeight))
-    {
-        if (vertices.count(end) < 1)
-        {
-            Vertex* temp = new Vertex(end);
-            vertices.insert({ end,temp });
-            numberOfVertices++;
+/** add a batch of edges, same result as calling add on each in turn
+    the batch is sorted by start and end, the first of several
+    records for the same edge is kept, self-loops are dropped,
+    missing vertices are created together and each vertex gets its
+    new edges in one pass with Vertex::connectSorted
+    return the number of edges added */
+int Graph::addEdges(const EdgeRecord* edges, size_t count) {
+    if (verbose) {
+        for (size_t i = 0; i < count; ++i) {
+            std::cout << edges[i].start << ' ' << edges[i].end << ' '
+                << edges[i].weight << '\n';
         }
-        if (vertices.count(start) < 1)
-        {
-            Vertex* temp = new Vertex(start);
-            vertices.insert({ start,temp });
+    }
+
+    // sort positions rather than records, ties keep input order
+    std::vector<size_t> order;
+    order.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        if (edges[i].start != edges[i].end) order.push_back(i);
+    }
+    if (order.empty()) return 0;
+    std::sort(order.begin(), order.end(), [edges](size_t a, size_t b) {
+        int byStart = edges[a].start.compare(edges[b].start);
+        if (byStart != 0) return byStart < 0;
+        int byEnd = edges[a].end.compare(edges[b].end);
+        return byEnd != 0 ? byEnd < 0 : a < b;
+    });
+
+    // every label once, in order, so each map insert gets a close hint
+    std::vector<const std::string*> labels;
+    labels.reserve(order.size() * 2);
+    for (size_t i : order) {
+        labels.push_back(&edges[i].start);
+        labels.push_back(&edges[i].end);
+    }
+    auto lessLabel = [](const std::string* a, const std::string* b) {
+        return *a < *b;
+    };
+    std::sort(labels.begin(), labels.end(), lessLabel);
+    labels.erase(std::unique(labels.begin(), labels.end(),
+                             [](const std::string* a, const std::string* b) {
+                                 return *a == *b;
+                             }),
+                 labels.end());
+    for (const std::string* label : labels) {
+        auto position = vertices.lower_bound(*label);
+        if (position == vertices.end() || position->first != *label) {
+            vertices.emplace_hint(position, *label,
+                                  createVertex(*label, numberOfVertices));
             numberOfVertices++;
         }
-        it = vertices.find(start);
-        it->second->connect(end, edgeWeight);
+    }
 
-        return true;
+    int added = 0;
+    std::vector<Edge> run;
+    for (size_t at = 0; at < order.size();) {
+        const std::string& start = edges[order[at]].start;
+        run.clear();
+        for (; at < order.size() && edges[order[at]].start == start; ++at) {
+            const EdgeRecord& edge = edges[order[at]];
+            // only the first record of a repeated edge is kept
+            if (run.empty() || run.back().getEndVertex() != edge.end) {
+                run.emplace_back(edge.end, edge.weight);
+            }
+        }
+        Vertex* startVertex = vertices.find(start)->second;
+        if (!idAdjacency) {
+            added += startVertex->connectSorted(run);
+            continue;
+        }
+        std::vector<const Edge*> newEdges;
+        added += startVertex->connectSorted(run, &newEdges);
+        for (const Edge* edge : newEdges) {
+            edgeChanged(startVertex->getId(),
+                        vertices.find(edge->getEndVertex())->second->getId(),
+                        EdgeChange::Added, edge->getWeight(),
+                        edge->getWeight());
+        }
     }
-    return false;
+    numberOfEdges += added;
+    if (added > 0) invalidateSnapshot();
+    return added;
+}
+
+/** addEdges for a whole vector */
+int Graph::addEdges(const std::vector<EdgeRecord>& edges) {
+    return addEdges(edges.data(), edges.size());
+}
+
+/** remove the edge between start and end vertex
+    calls Vertex::disconnect, vertices are kept
+    return true if the edge existed */
+bool Graph::remove(const std::string& start, const std::string& end) {
+    Vertex* startVertex = findVertex(start);
+    if (startVertex == nullptr) return false;
+    int oldWeight = startVertex->getEdgeWeight(end);
+    if (!startVertex->disconnect(end)) return false;
+    numberOfEdges--;
+    if (idAdjacency) {
+        edgeChanged(startVertex->getId(), findVertex(end)->getId(),
+                    EdgeChange::Removed, oldWeight, oldWeight);
+    }
+    invalidateSnapshot(&start);
+    return true;
+}
+
+/** change the weight of the edge between start and end
+    return false if there is no such edge */
+bool Graph::setEdgeWeight(const std::string& start, const std::string& end,
+                          int edgeWeight) {
+    Vertex* startVertex = findVertex(start);
+    if (startVertex == nullptr) return false;
+    int oldWeight = 0;
+    if (!startVertex->setEdgeWeight(end, edgeWeight, &oldWeight)) {
+        return false;
+    }
+    if (oldWeight == edgeWeight) return true;
+    if (idAdjacency) {
+        edgeChanged(startVertex->getId(), findVertex(end)->getId(),
+                    EdgeChange::Reweighted, oldWeight, edgeWeight);
+    }
+    invalidateSnapshot(&start);
+    return true;
 }
 
 
@@ -82,53 +271,260 @@ bool Graph::add(std::string start, std::string end, int edgeWeight) {
 int Graph::getEdgeWeight(std::string start, std::string end) const {
 
     auto it = vertices.find(start);
+    if (it == vertices.end()) return INT_MAX;
     return it->second->getEdgeWeight(end);
 }
 
 /** read edges from file
     the first line of the file is an integer, indicating number of edges
     each edge line is in the form of "string string int"
-    fromVertex  toVertex    edgeWeight */
+    fromVertex  toVertex    edgeWeight
+    the file is mapped into memory and large files are parsed in
+    chunks on getThreadPool, then added with addEdges */
 void Graph::readFile(std::string filename) {
-    std::ifstream infile(filename);
-    if (!infile) {
+    QueryStats stats;
+    StatsScope scope("readFile", statsHook, stats);
+    MappedFile file;
+    if (!file.open(filename)) {
         std::cout << "File could not be opened" << std::endl;
         return;
     }
+    const char* at = file.data();
+    const char* stop = at + file.size();
 
-    std::string start, end;
-    int edgeWeight;
+    // add counts the edges, the header is only used to size buffers
+    int expectedEdges;
+    if (!parseHeader(at, stop, expectedEdges)) return;
 
-    infile >> numberOfEdges;
+    // small files are not worth waking the workers for
+    int numChunks = 1;
+    if (stop - at >= kParallelBytes) {
+        numChunks = getThreadPool().getNumThreads() * 4;
+    }
 
-    for (;;) {
+    // chunks start at the beginning of a line
+    std::vector<const char*> bounds(numChunks + 1, stop);
+    bounds[0] = at;
+    for (int c = 1; c < numChunks; ++c) {
+        const char* cut = at + (stop - at) / numChunks * c;
+        if (cut < bounds[c - 1]) cut = bounds[c - 1];
+        while (cut < stop && *cut != '\n') ++cut;
+        bounds[c] = cut < stop ? cut + 1 : stop;
+    }
+
+    std::vector<std::vector<EdgeRecord>> chunks(numChunks);
+    std::vector<char> complete(numChunks, 1);
+    size_t perChunk = expectedEdges > 0 ? expectedEdges / numChunks + 1 : 0;
+    auto parseChunks = [&](int first, int last, int) {
+        for (int c = first; c < last; ++c) {
+            chunks[c].reserve(perChunk);
+            complete[c] = parseEdges(bounds[c], bounds[c + 1], chunks[c]);
+        }
+    };
+    if (numChunks == 1) {
+        parseChunks(0, 1, 0);
+    } else {
+        getThreadPool().parallelFor(0, numChunks, 1, parseChunks);
+    }
+
+    // chunks in file order keep the first record of an edge, and loading
+    // stops at the first bad record like >> did
+    for (int c = 0; c < numChunks; ++c) {
+        addEdges(chunks[c]);
+        if (!complete[c]) break;
+    }
+}
 
-        // Grab start vertex, end vertex, weight of the edge
-        infile >> start >> end >> edgeWeight;
+/** write the graph to filename in the binary format of
+    CsrGraph::saveBinary, which read-only users can map directly
+    return false if the file could not be written */
+bool Graph::saveBinary(const std::string& filename) const {
+    return getSnapshot()->saveBinary(filename);
+}
 
-        add(start, end, edgeWeight);
+/** replace the graph with one written by saveBinary
+    the mapped file becomes the snapshot used by queries when its ids
+    are in getVertexOrder, otherwise the snapshot is renumbered
+    return false if the file could not be read or is damaged,
+    the graph is then left unchanged */
+bool Graph::loadBinary(const std::string& filename) {
+    auto csr = std::make_shared<CsrGraph>();
+    if (!csr->loadBinary(filename)) return false;
 
+    // the vertices get label-order ids, as after readFile
+    std::vector<int> byLabel(csr->getNumVertices());
+    bool labelOrder = true;
+    for (int rank = 0; rank < csr->getNumVertices(); ++rank) {
+        byLabel[rank] = csr->vertexByLabel(rank);
+        labelOrder = labelOrder && byLabel[rank] == rank;
+    }
+    if (!labelOrder) {
+        csr = std::make_shared<CsrGraph>(csr->permute(byLabel));
+    }
 
-        if (infile.eof()) break;
+    // the trackers read the old vertex ids, start them again afterwards
+    std::vector<std::string> tracked;
+    for (const auto& item : trackedSources) {
+        tracked.push_back(item.first);
     }
+    trackedSources.clear();
+    idAdjacency.reset();
+    destroyVertices();
+    numberOfEdges = 0;
+
+    // labels are sorted, so every vertex goes at the end
+    int n = csr->getNumVertices();
+    for (int v = 0; v < n; ++v) {
+        std::string label = csr->getLabel(v);
+        Vertex* vertex = createVertex(label, v);
+        vertices.emplace_hint(vertices.end(), std::move(label), vertex);
+    }
+    numberOfVertices = n;
+    for (int v = 0; v < n; ++v) {
+        for (int e = csr->edgeBegin(v); e < csr->edgeEnd(v); ++e) {
+            vertexById[v]->connect(csr->getLabel(csr->edgeTarget(e)),
+                                   csr->edgeWeight(e));
+        }
+    }
+    numberOfEdges = csr->getNumEdges();
+    for (const std::string& source : tracked) {
+        trackSource(source);
+    }
+
+    invalidateSnapshot();
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    if (vertexOrder == VertexOrder::Label) {
+        snapshot = csr;
+    } else {
+        snapshot = std::make_shared<const CsrGraph>(
+            csr->reorder(vertexOrder));
+    }
+    return true;
 }
 
+/** print every edge passed to add, addEdges and readFile,
+    off by default */
+void Graph::setVerbose(bool verbose) { this->verbose = verbose; }
+
+/** return true if add, addEdges and readFile print the edges */
+bool Graph::isVerbose() const { return verbose; }
+
+/** number the vertices of getSnapshot in the given order, label
+    order by default; other orders put neighbors closer in memory,
+    which speeds up queries on large graphs but changes the order
+    in which parallelBreadthFirstTraversal visits vertices */
+void Graph::setVertexOrder(VertexOrder order) {
+    if (order == vertexOrder) return;
+    vertexOrder = order;
+    invalidateSnapshot();
+}
+
+/** return the vertex order of getSnapshot */
+VertexOrder Graph::getVertexOrder() const { return vertexOrder; }
+
+/** pass the stats of every traversal, djikstraCostToAllVertices,
+    readFile and add to hook, nullptr for none; set it before
+    queries start, hook must outlive the graph or be reset
+    only called when built with GRAPH_STATS, see QueryStats */
+void Graph::setStatsHook(StatsHook* hook) { statsHook = hook; }
+
+/** return the hook given to setStatsHook */
+StatsHook* Graph::getStatsHook() const { return statsHook; }
+
 /** depth-first traversal starting from startLabel
     call the function visit on each vertex label */
 void Graph::depthFirstTraversal(std::string startLabel,
-    void visit(const std::string&)) {
-    unvisitVertices();
-    Vertex* temp = vertices.at(startLabel);
-    depthFirstTraversalHelper(temp, visit);
+    void visit(const std::string&)) const {
+    TraversalState state;
+    depthFirstTraversal(startLabel, visit, state);
+}
+
+/** depth-first traversal using the caller's state
+    the state is reset, so it can be reused between queries */
+void Graph::depthFirstTraversal(const std::string& startLabel,
+    void visit(const std::string&), TraversalState& state) const {
+    state.reset(numberOfVertices);
+    StatsScope scope("depthFirstTraversal", statsHook, state.getStats());
+    if (kStatsEnabled) state.getStats().mapLookups++;
+    const Vertex* temp = vertices.at(startLabel);
+    depthFirstTraversalHelper(temp, visit, state);
 }
 
 /** breadth-first traversal starting from startLabel
     call the function visit on each vertex label */
 void Graph::breadthFirstTraversal(std::string startLabel,
-    void visit(const std::string&)) {
-    unvisitVertices();
-    Vertex* temp = vertices.at(startLabel);
-    breadthFirstTraversalHelper(temp, visit);
+    void visit(const std::string&)) const {
+    TraversalState state;
+    breadthFirstTraversal(startLabel, visit, state);
+}
+
+/** breadth-first traversal using the caller's state
+    the state is reset, so it can be reused between queries */
+void Graph::breadthFirstTraversal(const std::string& startLabel,
+    void visit(const std::string&), TraversalState& state) const {
+    state.reset(numberOfVertices);
+    StatsScope scope("breadthFirstTraversal", statsHook, state.getStats());
+    if (kStatsEnabled) state.getStats().mapLookups++;
+    const Vertex* temp = vertices.at(startLabel);
+    breadthFirstTraversalHelper(temp, visit, state);
+}
+
+/** breadthFirstTraversal expanded level by level on getThreadPool
+    by ParallelBfs, visits the vertices in the same order
+    does nothing if startLabel is not in the graph
+    stats, if given, receives the number of vertices visited */
+void Graph::parallelBreadthFirstTraversal(
+    const std::string& startLabel, void visit(const std::string&),
+    QueryStats* stats) const {
+    QueryStats counters;
+    QueryStats& target = stats != nullptr ? *stats : counters;
+    if (kStatsEnabled) target = QueryStats();
+    StatsScope scope("parallelBreadthFirstTraversal", statsHook, target);
+    std::shared_ptr<const CsrGraph> csr = getSnapshot();
+    int start = csr->findVertex(startLabel);
+    if (start < 0) return;
+    ParallelBfs search(getThreadPool());
+    search.run(*csr, start, true);
+    if (kStatsEnabled) target.verticesSettled = search.getOrder().size();
+    for (int v : search.getOrder()) {
+        visit(csr->getLabel(v));
+    }
+}
+
+/** number of edges on a shortest path from startLabel to every
+    vertex it can reach, found by ParallelBfs on getThreadPool
+    hops["F"] = 2 indicates "F" is two edges away
+    parent["F"] = "C" indicates the last edge comes from "C", the
+    smallest label one hop closer; startLabel is left out */
+void Graph::hopCountToAllVertices(
+    const std::string& startLabel,
+    std::map<std::string, int>& hops,
+    std::map<std::string, std::string>& parent) const {
+    std::shared_ptr<const CsrGraph> csr = getSnapshot();
+    int start = csr->findVertex(startLabel);
+    if (start < 0) {
+        hops.clear();
+        parent.clear();
+        return;
+    }
+    ParallelBfs search(getThreadPool());
+    search.run(*csr, start);
+    const std::vector<int>& depth = search.getDepths();
+    std::vector<int> reached(depth.size());
+    for (size_t v = 0; v < depth.size(); ++v) {
+        reached[v] = depth[v] < 0 ? INT_MAX : depth[v];
+    }
+    csr->fillCostMaps(start, reached, search.getParents(), hops, parent);
+}
+
+/** return true if end can be reached from start
+    the search stops at the first time it sees end */
+bool Graph::isReachable(const std::string& start,
+                        const std::string& end) const {
+    if (findVertex(end) == nullptr) return false;
+    return breadthFirstTraversal(start, [&end](const std::string& label) {
+        return label == end ? VisitResult::Stop : VisitResult::Continue;
+    });
 }
 
 /** find the lowest cost from startLabel to all vertices that can be reached
@@ -137,146 +533,463 @@ void Graph::breadthFirstTraversal(std::string startLabel,
     weight["F"] = 10 indicates the cost to get to "F" is 10
     record the shortest path to each vertex using given map previous
     previous["F"] = "C" indicates get to "F" via "C"
+    runs DijkstraEngine on the compact copy from getSnapshot
+    stats, if given, receives the work done by the search
 
     cpplint gives warning to use pointer instead of a non-const map
     which I am ignoring for readability */
 void Graph::djikstraCostToAllVertices(
-    
     std::string startLabel,
     std::map<std::string, int>& weight,
-    std::map<std::string, std::string>& previous) {
-    weight.clear();
-    previous.clear();
-    unvisitVertices();
-    auto cmp = [&](std::string a, std::string b) { return weight[a] > weight[b]; };
-    std::priority_queue<std::string, std::vector<std::string>, decltype(cmp)> pq(cmp);
-
-    Vertex* temp = findVertex(startLabel);
-    std::string s = temp->getNextNeighbor();
-    while (temp->getLabel() != s) {
-
-        weight[s] = getEdgeWeight(temp->getLabel(), s);
-        previous[s] = startLabel;
-        pq.push(s);
-        s = temp->getNextNeighbor();
-    }
-
-    std::set<std::string> vertexSet;
-    vertexSet.insert(startLabel);
-    while (!pq.empty()) {
-       
-      
-            Vertex* v = findVertex(pq.top());
-            pq.pop();
-            if (v->getLabel() == startLabel) continue;
-
-        // Vertex not found in the vertexSet
-        if (vertexSet.find(v->getLabel()) == vertexSet.end()) {
-            for (auto it = vertices.find(v->getNextNeighbor());
-                it != vertices.end(); it++) {
-
-                // Neighbor label
-                std::string u = it->first;
-                // Weight from vertex to neighbor
-                int edgeWeight = getEdgeWeight(v->getLabel(), u);
-
-                // If it's the last node, edgeweight will be -1 
-                if (edgeWeight < 0) continue;
-                if (u == startLabel) continue;
-                //weight[neighbor] couldn't be found
-                if (weight.find(u) == weight.end()) {
-                    weight[u] = weight[v->getLabel()] + edgeWeight;
-                    previous[u] = v->getLabel();
-                    pq.push(u);
-                }
-                else {
-                    if (weight[u] > weight[v->getLabel()] + edgeWeight) {
-
-                        weight[u] = weight[v->getLabel()] + edgeWeight;
-                        previous[u] = v->getLabel();
-                        pq.push(u);
-                    }
-                    else {
-                        continue;
-                    }
-                }
+    std::map<std::string, std::string>& previous,
+    QueryStats* stats) const {
+    QueryStats counters;
+    QueryStats& target = stats != nullptr ? *stats : counters;
+    if (kStatsEnabled) target = QueryStats();
+    StatsScope scope("djikstraCostToAllVertices", statsHook, target);
+    std::shared_ptr<const CsrGraph> csr = getSnapshot();
+    int start = csr->findVertex(startLabel);
+    if (start < 0) {
+        weight.clear();
+        previous.clear();
+        return;
+    }
+    DijkstraEngine engine;
+    engine.run(*csr, start);
+    csr->fillCostMaps(start, engine.getDistances(), engine.getPredecessors(),
+                      weight, previous);
+    if (kStatsEnabled) target = engine.getStats();
+}
 
-            }
-        }
+/** lowest costs from startLabel to all vertices, like
+    djikstraCostToAllVertices but kept as arrays indexed by the ids
+    of getSnapshot, see SsspResult; nothing is reached if startLabel
+    is not in the graph
+    stats, if given, receives the work done by the search */
+SsspResult Graph::shortestPathsFrom(const std::string& startLabel,
+                                    QueryStats* stats) const {
+    QueryStats counters;
+    QueryStats& target = stats != nullptr ? *stats : counters;
+    if (kStatsEnabled) target = QueryStats();
+    StatsScope scope("shortestPathsFrom", statsHook, target);
+    std::shared_ptr<const CsrGraph> csr = getSnapshot();
+    int start = csr->findVertex(startLabel);
+    if (start < 0) return SsspResult();
+    DijkstraEngine engine;
+    engine.run(*csr, start);
+    if (kStatsEnabled) target = engine.getStats();
+    std::vector<int> distance;
+    std::vector<int> parent;
+    engine.takeResults(distance, parent);
+    return SsspResult(std::move(csr), start, std::move(distance),
+                      std::move(parent));
+}
+
+/** shortestPathsFrom through a cache of recent results, see
+    SsspCache; a repeated source costs a hash lookup until the
+    graph changes in a way that can alter its costs
+    the result is shared with other callers and can be queried
+    from several threads at once */
+std::shared_ptr<const SsspResult> Graph::cachedShortestPathsFrom(
+    const std::string& startLabel) const {
+    std::shared_ptr<const SsspResult> result =
+        ssspCache.find(startLabel, version);
+    if (result) return result;
+    result = std::make_shared<const SsspResult>(
+        shortestPathsFrom(startLabel));
+    // a source that is not in the graph yet would look unaffected
+    // when it gets its first edge, so it is not kept
+    if (result->getSource() >= 0) {
+        ssspCache.insert(startLabel, version, result);
     }
+    return result;
+}
 
+/** change the bytes the cachedShortestPathsFrom cache may hold,
+    0 turns it off */
+void Graph::setSsspCacheLimit(size_t bytes) {
+    ssspCache.setMemoryLimit(bytes);
 }
 
-/** helper for depthFirstTraversal */
-void Graph::depthFirstTraversalHelper(Vertex* startVertex,
-    void visit(const std::string&)) {
-    startVertex->visit();
-    visit(startVertex->getLabel());
-    // Recur for all the vertices adjacent
-    // to this vertex
-    while (true)
-    {
-        std::string insert = startVertex->getNextNeighbor();
-        if (insert.compare(startVertex->getLabel()) == 0)
-        {
-            break;
+/** return the bytes the cachedShortestPathsFrom cache may hold */
+size_t Graph::getSsspCacheLimit() const {
+    return ssspCache.getMemoryLimit();
+}
+
+/** hits, misses and size of the cachedShortestPathsFrom cache */
+SsspCacheStats Graph::getSsspCacheStats() const {
+    return ssspCache.getStats();
+}
+
+/** djikstraCostToAllVertices computed by parallel delta-stepping
+    on getThreadPool, same costs; where two shortest paths tie,
+    previous holds the smaller label, so it can differ from
+    djikstraCostToAllVertices on ties
+    delta is the bucket width, 0 picks one from the edge weights
+    stats, if given, receives the number of vertices reached */
+void Graph::deltaSteppingCostToAllVertices(
+    const std::string& startLabel,
+    std::map<std::string, int>& weight,
+    std::map<std::string, std::string>& previous,
+    int delta, QueryStats* stats) const {
+    QueryStats counters;
+    QueryStats& target = stats != nullptr ? *stats : counters;
+    if (kStatsEnabled) target = QueryStats();
+    StatsScope scope("deltaSteppingCostToAllVertices", statsHook, target);
+    std::shared_ptr<const CsrGraph> csr = getSnapshot();
+    int start = csr->findVertex(startLabel);
+    if (start < 0) {
+        weight.clear();
+        previous.clear();
+        return;
+    }
+    DeltaStepping search(getThreadPool(), delta);
+    search.run(*csr, start);
+    if (kStatsEnabled) {
+        const std::vector<int>& distance = search.getDistances();
+        target.verticesSettled = distance.size() -
+            std::count(distance.begin(), distance.end(), INT_MAX);
+    }
+    csr->fillCostMaps(start, search.getDistances(), search.getPredecessors(),
+                      weight, previous);
+}
+
+/** keep the lowest costs from source up to date as the graph changes
+    add, addEdges, remove and setEdgeWeight repair only the costs
+    they change, see DynamicSssp; weights must not be negative, so
+    an edge with a negative weight stops tracking every source
+    return false if source is not in the graph or a weight is
+    negative */
+bool Graph::trackSource(const std::string& source) {
+    Vertex* vertex = findVertex(source);
+    if (vertex == nullptr) return false;
+    if (trackedSources.count(source) > 0) return true;
+    if (getSnapshot()->hasNegativeWeights()) return false;
+    if (!idAdjacency) {
+        // built on first use, from then on every edge change updates it
+        idAdjacency.reset(new IdAdjacency());
+        for (size_t id = 0; id < vertexById.size(); ++id) {
+            idAdjacency->addVertex();
         }
-        Vertex* temp = vertices.at(insert);
-        if (!temp->isVisited())
-        {
-            depthFirstTraversalHelper(temp, visit);
+        for (Vertex* from : vertexById) {
+            for (const Edge& edge : from->neighbors()) {
+                idAdjacency->addEdge(
+                    from->getId(),
+                    vertices.find(edge.getEndVertex())->second->getId(),
+                    edge.getWeight());
+            }
         }
     }
+    trackedSources[source].reset(
+        new DynamicSssp(*idAdjacency, vertex->getId()));
+    return true;
+}
 
+/** stop keeping the costs from source up to date */
+void Graph::untrackSource(const std::string& source) {
+    trackedSources.erase(source);
+    if (trackedSources.empty()) idAdjacency.reset();
 }
 
-/** helper for breadthFirstTraversal */
-void Graph::breadthFirstTraversalHelper(Vertex* startVertex,
-    void visit(const std::string&)) {
-    std::list<Vertex*> queue;
-    // Mark the current node as visited and enqueue it
-    startVertex->visit();
-    visit(startVertex->getLabel());
-    queue.push_back(startVertex);
+/** cost from a tracked source to end
+    INT_MAX if end cannot be reached or source is not tracked */
+int Graph::trackedCost(const std::string& source,
+                       const std::string& end) const {
+    auto it = trackedSources.find(source);
+    Vertex* endVertex = findVertex(end);
+    if (it == trackedSources.end() || endVertex == nullptr) return INT_MAX;
+    return it->second->getDistance(endVertex->getId());
+}
 
+/** labels on a lowest cost path from a tracked source to end,
+    source first; empty if end cannot be reached or source is not
+    tracked */
+std::vector<std::string> Graph::trackedPath(const std::string& source,
+                                            const std::string& end) const {
+    std::vector<std::string> path;
+    if (trackedCost(source, end) == INT_MAX) return path;
+    const DynamicSssp& tree = *trackedSources.find(source)->second;
+    for (int v = findVertex(end)->getId(); v >= 0;
+         v = tree.getPredecessor(v)) {
+        path.push_back(vertexById[v]->getLabel());
+    }
+    std::reverse(path.begin(), path.end());
+    return path;
+}
 
+/** lowest cost from each of sources to every vertex, one row per
+    source in the order given, labels not in the graph give rows
+    of INT_MAX; the sources are shared out over getThreadPool
+    withPredecessors keeps the shortest path trees for path */
+DistanceMatrix Graph::costsFromSources(
+    const std::vector<std::string>& sources, bool withPredecessors) const {
+    std::shared_ptr<const CsrGraph> csr = getSnapshot();
+    std::vector<int> ids;
+    ids.reserve(sources.size());
+    for (const std::string& label : sources) {
+        ids.push_back(csr->findVertex(label));
+    }
+    DistanceMatrix matrix(csr, std::move(ids), withPredecessors);
+    matrix.compute(getThreadPool());
+    return matrix;
+}
 
-    while (!queue.empty())
-    {
-        // Dequeue a vertex from queue and print it
-        Vertex* temp = queue.front();
-        std::cout << temp << " ";
-        queue.pop_front();
-
-        // Get all adjacent vertices of the dequeued
-        // vertex s. If a adjacent has not been visited,
-        // then mark it visited and enqueue it
-        while (true)
-        {
-            std::string insert = temp->getNextNeighbor();
-            if (insert.compare(temp->getLabel()) == 0)
-            {
-                break;
-            }
-            Vertex* temp = vertices.at(insert);
-            if (!temp->isVisited())
-            {
-                temp->visit();
-                visit(temp->getLabel());
-                queue.push_back(temp);
-            }
+/** lowest cost between every pair of vertices, with ids of
+    getSnapshot, computed on getThreadPool by blocked Floyd-Warshall
+    or Johnson, see AllPairsPaths; every cost is INT_MAX if the
+    graph has a negative cycle
+    withNextHops keeps the next-hop table for path */
+AllPairsPaths Graph::allPairsCosts(bool withNextHops,
+                                   ApspMethod method) const {
+    AllPairsPaths matrix(getSnapshot(), withNextHops, method);
+    matrix.compute(getThreadPool());
+    return matrix;
+}
+
+/** return the worker threads used by parallel queries
+    created on first use with one thread per core */
+ThreadPool& Graph::getThreadPool() const {
+    std::lock_guard<std::mutex> lock(threadPoolMutex);
+    if (!threadPool) {
+        threadPool.reset(new ThreadPool());
+    }
+    return *threadPool;
+}
+
+/** find the lowest cost path from start to end
+    runs a bidirectional Dijkstra search that stops as soon as the
+    forward and backward searches meet, so only the part of the graph
+    near the path is explored
+    uses A* with landmark bounds instead if buildLandmarks or
+    loadLandmarks was called since the graph last changed, and the
+    contraction hierarchy if buildContractionHierarchy was
+    stats, if given, receives the number of vertices settled */
+PathResult Graph::shortestPath(const std::string& start,
+                               const std::string& end,
+                               QueryStats* stats) const {
+    QueryStats counters;
+    QueryStats& work = stats != nullptr ? *stats : counters;
+    if (kStatsEnabled) work = QueryStats();
+    StatsScope scope("shortestPath", statsHook, work);
+    PathResult result{ INT_MAX, {} };
+    std::shared_ptr<const CsrGraph> csr = getSnapshot();
+    int source = csr->findVertex(start);
+    int target = csr->findVertex(end);
+    if (source < 0 || target < 0) return result;
+    if (components && components->getWeak(source) !=
+        components->getWeak(target)) {
+        return result;
+    }
+
+    // one search per thread, its arrays are reused by later queries
+    const std::vector<int>* path;
+    if (hierarchy) {
+        thread_local ChSearch search;
+        result.cost = search.run(*hierarchy, source, target);
+        path = &search.getPath();
+        if (kStatsEnabled) work.verticesSettled = search.getSettledCount();
+    } else if (landmarks) {
+        thread_local AltSearch search;
+        result.cost = search.run(*csr, *landmarks, source, target);
+        path = &search.getPath();
+        if (kStatsEnabled) work.verticesSettled = search.getSettledCount();
+    } else {
+        thread_local BidirectionalDijkstra search;
+        result.cost = search.run(*csr, source, target);
+        path = &search.getPath();
+        if (kStatsEnabled) work.verticesSettled = search.getSettledCount();
+    }
+    for (int v : *path) {
+        result.path.push_back(csr->getLabel(v));
+    }
+    return result;
+}
+
+/** shortestPath with the result in the format of
+    djikstraCostToAllVertices, limited to the vertices on the path
+    weight has the cost to get to each of them, previous the vertex
+    before it; both are empty if end cannot be reached */
+void Graph::shortestPath(const std::string& start, const std::string& end,
+                         std::map<std::string, int>& weight,
+                         std::map<std::string, std::string>& previous) const {
+    weight.clear();
+    previous.clear();
+    PathResult result = shortestPath(start, end);
+    int cost = 0;
+    for (size_t i = 1; i < result.path.size(); ++i) {
+        const std::string& from = result.path[i - 1];
+        const std::string& to = result.path[i];
+        cost += findVertex(from)->getEdgeWeight(to);
+        weight[to] = cost;
+        previous[to] = from;
+    }
+}
+
+/** preprocessing for mostly static graphs, contract all vertices so
+    shortestPath only searches a few hundred of them
+    dropped by add and remove
+    return false if there are negative edge weights */
+bool Graph::buildContractionHierarchy() {
+    auto built = std::make_shared<ContractionHierarchy>();
+    if (!built->build(*getSnapshot())) {
+        hierarchy.reset();
+        return false;
+    }
+    hierarchy = built;
+    return true;
+}
+
+/** return true if shortestPath can use a contraction hierarchy */
+bool Graph::hasContractionHierarchy() const { return hierarchy != nullptr; }
+
+/** preprocessing for shortestPath, choose count landmark vertices and
+    store the costs to and from each of them
+    dropped by add and remove, edge weights must not be negative */
+void Graph::buildLandmarks(int count) {
+    std::shared_ptr<const CsrGraph> csr = getSnapshot();
+    if (csr->hasNegativeWeights()) {
+        landmarks.reset();
+        return;
+    }
+    auto index = std::make_shared<LandmarkIndex>();
+    index->build(*csr, count);
+    landmarks = index;
+}
+
+/** return true if shortestPath can use landmark bounds */
+bool Graph::hasLandmarks() const { return landmarks != nullptr; }
+
+/** write the landmark tables to a binary file
+    return false if there are none or the file could not be written */
+bool Graph::saveLandmarks(const std::string& filename) const {
+    return landmarks && landmarks->save(filename);
+}
+
+/** read landmark tables written by saveLandmarks
+    return false if the file could not be read or belongs to a
+    different graph */
+bool Graph::loadLandmarks(const std::string& filename) {
+    auto index = std::make_shared<LandmarkIndex>();
+    if (!index->load(filename, *getSnapshot())) return false;
+    landmarks = index;
+    return true;
+}
+
+/** preprocessing for routing, find the weakly and strongly connected
+    components on getThreadPool, see Components; shortestPath then
+    answers at once when start and end are not connected
+    dropped by add and remove */
+void Graph::buildComponents() {
+    components = std::make_shared<const Components>(*getSnapshot(),
+                                                    getThreadPool());
+}
+
+/** return the components found by buildComponents, nullptr if they
+    were not built; ids are those of getSnapshot */
+std::shared_ptr<const Components> Graph::getComponents() const {
+    return components;
+}
+
+/** return true if start and end are in the same weakly connected
+    component, that is joined when edge directions are ignored;
+    if not, neither can be reached from the other
+    constant time after buildComponents, otherwise linear */
+bool Graph::sameComponent(const std::string& start,
+                          const std::string& end) const {
+    std::shared_ptr<const CsrGraph> csr = getSnapshot();
+    int source = csr->findVertex(start);
+    int target = csr->findVertex(end);
+    if (source < 0 || target < 0) return false;
+    if (components) {
+        return components->getWeak(source) == components->getWeak(target);
+    }
+    std::vector<int> weak = Components::weakComponents(*csr,
+                                                       getThreadPool());
+    return weak[source] == weak[target];
+}
+
+/** return true if start and end are in the same strongly connected
+    component, so each can be reached from the other
+    constant time after buildComponents, otherwise linear */
+bool Graph::sameStrongComponent(const std::string& start,
+                                const std::string& end) const {
+    std::shared_ptr<const CsrGraph> csr = getSnapshot();
+    int source = csr->findVertex(start);
+    int target = csr->findVertex(end);
+    if (source < 0 || target < 0) return false;
+    if (components) {
+        return components->getStrong(source) ==
+            components->getStrong(target);
+    }
+    std::vector<int> strong = Components::strongComponentsTarjan(*csr);
+    return strong[source] == strong[target];
+}
+
+/** return a number that changes every time the graph does */
+uint64_t Graph::getVersion() const { return version; }
+
+/** return the compact copy of the graph used by shortest-path queries
+    built on first use and rebuilt after the graph changes
+    vertex ids follow getVertexOrder
+    the returned copy stays valid while the caller holds it */
+std::shared_ptr<const CsrGraph> Graph::getSnapshot() const {
+    std::lock_guard<std::mutex> lock(snapshotMutex);
+    if (!snapshot) {
+        if (vertexOrder == VertexOrder::Label) {
+            snapshot = std::make_shared<const CsrGraph>(freeze());
+        } else {
+            CsrGraph reordered = freeze().reorder(vertexOrder);
+            snapshot = std::make_shared<const CsrGraph>(std::move(reordered));
         }
     }
+    return snapshot;
 }
 
-/** mark all verticies as unvisited */
-void Graph::unvisitVertices() {
+/** drop the cached compact copy and everything derived from it
+    after the graph changed, and raise the version
+    changedFrom, if given, is the only vertex whose edges changed,
+    cached results that do not reach it are kept */
+void Graph::invalidateSnapshot(const std::string* changedFrom) {
+    {
+        std::lock_guard<std::mutex> lock(snapshotMutex);
+        snapshot.reset();
+        landmarks.reset();
+        hierarchy.reset();
+        components.reset();
+    }
+    ++version;
+    if (changedFrom != nullptr) {
+        ssspCache.keepUnaffected(*changedFrom, version - 1, version);
+    }
+}
+
+/** build a compact, read-only copy of the graph
+    vertex ids follow the alphabetical order of the labels
+    later changes to the graph are not reflected in the copy */
+CsrGraph Graph::freeze() const {
+    std::vector<std::string> labels;
+    labels.reserve(vertices.size());
+    for (const auto& item : vertices) {
+        labels.push_back(item.first);
+    }
 
-    //.second refers to the vertex pointer
+    std::vector<int> offsets;
+    std::vector<int> targets;
+    std::vector<int> weights;
+    offsets.reserve(vertices.size() + 1);
+    offsets.push_back(0);
     for (const auto& item : vertices) {
-        item.second->unvisit();
-        item.second->setIterations();
+        for (const Edge& edge : item.second->neighbors()) {
+            // labels are sorted, so the id is the position in labels
+            auto pos = std::lower_bound(labels.begin(), labels.end(),
+                                        edge.getEndVertex());
+            targets.push_back(static_cast<int>(pos - labels.begin()));
+            weights.push_back(edge.getWeight());
+        }
+        offsets.push_back(static_cast<int>(targets.size()));
     }
+    return CsrGraph(std::move(labels), std::move(offsets),
+                    std::move(targets), std::move(weights));
 }
 
 /** find a vertex, if it does not exist return nullptr */
@@ -292,10 +1005,80 @@ Vertex* Graph::findVertex(const std::string& vertexLabel) const {
     return nullptr;
 }
 
+/** add the edge without printing it or dropping the snapshot
+    return false if it is a self-loop or already exists */
+bool Graph::insertEdge(const std::string& start, const std::string& end,
+                       int edgeWeight) {
+    if (start == end) return false;
+
+    // connect fails if the edge already exists, then nothing is created
+    Vertex* startVertex = findOrCreateVertex(start);
+    if (!startVertex->connect(end, edgeWeight)) return false;
+    Vertex* endVertex = findOrCreateVertex(end);
+    numberOfEdges++;
+    if (idAdjacency) {
+        edgeChanged(startVertex->getId(), endVertex->getId(),
+                    EdgeChange::Added, edgeWeight, edgeWeight);
+    }
+    return true;
+}
+
+/** tell the tracked sources that the edge from -> to was added,
+    removed or reweighted from oldWeight to newWeight; an added edge
+    has newWeight and a removed one had oldWeight */
+void Graph::edgeChanged(int from, int to, EdgeChange change, int oldWeight,
+                        int newWeight) {
+    bool lowered = false;
+    switch (change) {
+    case EdgeChange::Added:
+        idAdjacency->addEdge(from, to, newWeight);
+        lowered = true;
+        break;
+    case EdgeChange::Removed:
+        idAdjacency->removeEdge(from, to);
+        break;
+    default:
+        idAdjacency->setEdge(from, to, newWeight);
+        lowered = newWeight < oldWeight;
+        break;
+    }
+    // DynamicSssp would settle vertices again forever on a negative cycle
+    if (lowered && newWeight < 0) {
+        trackedSources.clear();
+        return;
+    }
+    for (auto& item : trackedSources) {
+        if (lowered) {
+            item.second->edgeLowered(from, to, newWeight);
+        } else {
+            item.second->edgeRaised(from, to);
+        }
+    }
+}
+
+/** construct a vertex in pool */
+Vertex* Graph::createVertex(const std::string& vertexLabel, int id) {
+    Vertex* vertex =
+        new (pool.allocate(sizeof(Vertex))) Vertex(vertexLabel, id, &pool);
+    vertexById.push_back(vertex);
+    if (idAdjacency) idAdjacency->addVertex();
+    return vertex;
+}
+
+/** destroy every vertex and give its memory back to pool */
+void Graph::destroyVertices() {
+    for (auto& item : vertices) {
+        item.second->~Vertex();
+        pool.deallocate(item.second, sizeof(Vertex));
+    }
+    vertices.clear();
+    vertexById.clear();
+    numberOfVertices = 0;
+}
+
 /** find a vertex, if it does not exist create it and return it */
 Vertex* Graph::findOrCreateVertex(const std::string& vertexLabel) {
     auto it = vertices.find(vertexLabel);
-    //abc
 
     // Found vertex
     if (it != vertices.end()) {
@@ -303,7 +1086,9 @@ Vertex* Graph::findOrCreateVertex(const std::string& vertexLabel) {
         return it->second;
     }
 
-    // Create new vertex and return it
-    Vertex* v = new Vertex(vertexLabel);
+    // Create new vertex with the next free id and return it
+    Vertex* v = createVertex(vertexLabel, numberOfVertices);
+    vertices.insert({ vertexLabel, v });
+    numberOfVertices++;
     return v;
 }
\ No newline at end of file
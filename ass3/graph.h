@@ -6,11 +6,49 @@
 #ifndef GRAPH_H
 #define GRAPH_H
 
+#include <cstdint>
 #include <map>
+#include <memory>
+#include <mutex>
 #include <string>
+#include <type_traits>
+#include <vector>
 
 #include "vertex.h"
 #include "edge.h"
+#include "allpairspaths.h"
+#include "components.h"
+#include "contractionhierarchy.h"
+#include "csrgraph.h"
+#include "distancematrix.h"
+#include "dynamicsssp.h"
+#include "idadjacency.h"
+#include "landmarkindex.h"
+#include "nodepool.h"
+#include "querystats.h"
+#include "ssspcache.h"
+#include "ssspresult.h"
+#include "threadpool.h"
+#include "traversalstate.h"
+
+/** result of a point-to-point query
+    cost is INT_MAX and path is empty if end cannot be reached
+    otherwise path lists the vertex labels from start to end */
+struct PathResult {
+    int cost;
+    std::vector<std::string> path;
+};
+
+/** returned by traversal visitors, Stop ends the traversal early
+    visitors returning void always continue */
+enum class VisitResult { Continue, Stop };
+
+/** one edge for Graph::addEdges */
+struct EdgeRecord {
+    std::string start;
+    std::string end;
+    int weight;
+};
 
 class Graph {
  public:
@@ -35,6 +73,27 @@ class Graph {
         or have multiple edges to another vertex */
     bool add(std::string start, std::string end, int edgeWeight = 0);
 
+    /** add a batch of edges, same result as calling add on each in turn
+        the batch is sorted by start and end, the first of several
+        records for the same edge is kept, self-loops are dropped,
+        missing vertices are created together and each vertex gets its
+        new edges in one pass with Vertex::connectSorted
+        return the number of edges added */
+    int addEdges(const EdgeRecord* edges, size_t count);
+
+    /** addEdges for a whole vector */
+    int addEdges(const std::vector<EdgeRecord>& edges);
+
+    /** remove the edge between start and end vertex
+        calls Vertex::disconnect, vertices are kept
+        return true if the edge existed */
+    bool remove(const std::string& start, const std::string& end);
+
+    /** change the weight of the edge between start and end
+        return false if there is no such edge */
+    bool setEdgeWeight(const std::string& start, const std::string& end,
+                       int edgeWeight);
+
     /** return weight of the edge between start and end
         returns INT_MAX if not connected or vertices don't exist */
     int getEdgeWeight(std::string start, std::string end) const;
@@ -42,18 +101,119 @@ class Graph {
     /** read edges from file
         the first line of the file is an integer, indicating number of edges
         each edge line is in the form of "string string int"
-        fromVertex  toVertex    edgeWeight */
+        fromVertex  toVertex    edgeWeight
+        the file is mapped into memory and large files are parsed in
+        chunks on getThreadPool, then added with addEdges */
     void readFile(std::string filename);
 
+    /** write the graph to filename in the binary format of
+        CsrGraph::saveBinary, which read-only users can map directly
+        return false if the file could not be written */
+    bool saveBinary(const std::string& filename) const;
+
+    /** replace the graph with one written by saveBinary
+        the mapped file becomes the snapshot used by queries when its ids
+        are in getVertexOrder, otherwise the snapshot is renumbered
+        return false if the file could not be read or is damaged,
+        the graph is then left unchanged */
+    bool loadBinary(const std::string& filename);
+
+    /** print every edge passed to add, addEdges and readFile,
+        off by default */
+    void setVerbose(bool verbose);
+
+    /** return true if add, addEdges and readFile print the edges */
+    bool isVerbose() const;
+
+    /** pass the stats of every traversal, djikstraCostToAllVertices,
+        readFile and add to hook, nullptr for none; set it before
+        queries start, hook must outlive the graph or be reset
+        only called when built with GRAPH_STATS, see QueryStats */
+    void setStatsHook(StatsHook* hook);
+
+    /** return the hook given to setStatsHook */
+    StatsHook* getStatsHook() const;
+
+    /** number the vertices of getSnapshot in the given order, label
+        order by default; other orders put neighbors closer in memory,
+        which speeds up queries on large graphs but changes the order
+        in which parallelBreadthFirstTraversal visits vertices */
+    void setVertexOrder(VertexOrder order);
+
+    /** return the vertex order of getSnapshot */
+    VertexOrder getVertexOrder() const;
+
     /** depth-first traversal starting from startLabel
-        call the function visit on each vertex label */
+        call the function visit on each vertex label
+        the graph is not changed, so concurrent traversals are safe */
     void depthFirstTraversal(std::string startLabel,
-                             void visit(const std::string&));
+                             void visit(const std::string&)) const;
+
+    /** depth-first traversal using the caller's state
+        the state is reset, so it can be reused between queries */
+    void depthFirstTraversal(const std::string& startLabel,
+                             void visit(const std::string&),
+                             TraversalState& state) const;
 
     /** breadth-first traversal starting from startLabel
-        call the function visit on each vertex label */
+        call the function visit on each vertex label
+        the graph is not changed, so concurrent traversals are safe */
     void breadthFirstTraversal(std::string startLabel,
-                               void visit(const std::string&));
+                               void visit(const std::string&)) const;
+
+    /** breadth-first traversal using the caller's state
+        the state is reset, so it can be reused between queries */
+    void breadthFirstTraversal(const std::string& startLabel,
+                               void visit(const std::string&),
+                               TraversalState& state) const;
+
+    /** depth-first traversal calling visit(label) on each vertex
+        visit is any callable returning void or VisitResult
+        returns true if visit stopped the traversal
+        does nothing if startLabel is not in the graph */
+    template <class Visitor>
+    bool depthFirstTraversal(const std::string& startLabel,
+                             Visitor&& visit) const;
+
+    /** template depth-first traversal using the caller's state */
+    template <class Visitor>
+    bool depthFirstTraversal(const std::string& startLabel, Visitor&& visit,
+                             TraversalState& state) const;
+
+    /** breadth-first traversal calling visit(label) on each vertex
+        visit is any callable returning void or VisitResult
+        returns true if visit stopped the traversal
+        does nothing if startLabel is not in the graph */
+    template <class Visitor>
+    bool breadthFirstTraversal(const std::string& startLabel,
+                               Visitor&& visit) const;
+
+    /** template breadth-first traversal using the caller's state */
+    template <class Visitor>
+    bool breadthFirstTraversal(const std::string& startLabel,
+                               Visitor&& visit, TraversalState& state) const;
+
+    /** breadthFirstTraversal expanded level by level on getThreadPool
+        by ParallelBfs, visits the vertices in the same order
+        does nothing if startLabel is not in the graph
+        stats, if given, receives the number of vertices visited */
+    void parallelBreadthFirstTraversal(const std::string& startLabel,
+                                       void visit(const std::string&),
+                                       QueryStats* stats = nullptr) const;
+
+    /** number of edges on a shortest path from startLabel to every
+        vertex it can reach, found by ParallelBfs on getThreadPool
+        hops["F"] = 2 indicates "F" is two edges away
+        parent["F"] = "C" indicates the last edge comes from "C", the
+        smallest label one hop closer; startLabel is left out */
+    void hopCountToAllVertices(
+        const std::string& startLabel,
+        std::map<std::string, int>& hops,
+        std::map<std::string, std::string>& parent) const;
+
+    /** return true if end can be reached from start
+        the search stops at the first time it sees end */
+    bool isReachable(const std::string& start, const std::string& end) const;
 
     /** find the lowest cost from startLabel to all vertices that can be reached
         using Djikstra's shortest-path algorithm
@@ -61,13 +221,177 @@ class Graph {
         weight["F"] = 10 indicates the cost to get to "F" is 10
         record the shortest path to each vertex using given map previous
         previous["F"] = "C" indicates get to "F" via "C"
+        runs DijkstraEngine on the compact copy from getSnapshot
+        stats, if given, receives the work done by the search
 
         cpplint gives warning to use pointer instead of a non-const map
         which I am ignoring for readability */
     void djikstraCostToAllVertices(
         std::string startLabel,
         std::map<std::string, int>& weight,
-        std::map<std::string, std::string>& previous);
+        std::map<std::string, std::string>& previous,
+        QueryStats* stats = nullptr) const;
+
+    /** lowest costs from startLabel to all vertices, like
+        djikstraCostToAllVertices but kept as arrays indexed by the ids
+        of getSnapshot, see SsspResult; nothing is reached if startLabel
+        is not in the graph
+        stats, if given, receives the work done by the search */
+    SsspResult shortestPathsFrom(const std::string& startLabel,
+                                 QueryStats* stats = nullptr) const;
+
+    /** shortestPathsFrom through a cache of recent results, see
+        SsspCache; a repeated source costs a hash lookup until the
+        graph changes in a way that can alter its costs
+        the result is shared with other callers and can be queried
+        from several threads at once */
+    std::shared_ptr<const SsspResult> cachedShortestPathsFrom(
+        const std::string& startLabel) const;
+
+    /** change the bytes the cachedShortestPathsFrom cache may hold,
+        0 turns it off */
+    void setSsspCacheLimit(size_t bytes);
+
+    /** return the bytes the cachedShortestPathsFrom cache may hold */
+    size_t getSsspCacheLimit() const;
+
+    /** hits, misses and size of the cachedShortestPathsFrom cache */
+    SsspCacheStats getSsspCacheStats() const;
+
+    /** djikstraCostToAllVertices computed by parallel delta-stepping
+        on getThreadPool, same costs; where two shortest paths tie,
+        previous holds the smaller label, so it can differ from
+        djikstraCostToAllVertices on ties
+        delta is the bucket width, 0 picks one from the edge weights
+        stats, if given, receives the number of vertices reached */
+    void deltaSteppingCostToAllVertices(
+        const std::string& startLabel,
+        std::map<std::string, int>& weight,
+        std::map<std::string, std::string>& previous,
+        int delta = 0, QueryStats* stats = nullptr) const;
+
+    /** keep the lowest costs from source up to date as the graph changes
+        add, addEdges, remove and setEdgeWeight repair only the costs
+        they change, see DynamicSssp; weights must not be negative, so
+        an edge with a negative weight stops tracking every source
+        return false if source is not in the graph or a weight is
+        negative */
+    bool trackSource(const std::string& source);
+
+    /** stop keeping the costs from source up to date */
+    void untrackSource(const std::string& source);
+
+    /** cost from a tracked source to end
+        INT_MAX if end cannot be reached or source is not tracked */
+    int trackedCost(const std::string& source, const std::string& end) const;
+
+    /** labels on a lowest cost path from a tracked source to end,
+        source first; empty if end cannot be reached or source is not
+        tracked */
+    std::vector<std::string> trackedPath(const std::string& source,
+                                         const std::string& end) const;
+
+    /** lowest cost from each of sources to every vertex, one row per
+        source in the order given, labels not in the graph give rows
+        of INT_MAX; the sources are shared out over getThreadPool
+        withPredecessors keeps the shortest path trees for path */
+    DistanceMatrix costsFromSources(const std::vector<std::string>& sources,
+                                    bool withPredecessors = false) const;
+
+    /** lowest cost between every pair of vertices, with ids of
+        getSnapshot, computed on getThreadPool by blocked Floyd-Warshall
+        or Johnson, see AllPairsPaths; every cost is INT_MAX if the
+        graph has a negative cycle
+        withNextHops keeps the next-hop table for path */
+    AllPairsPaths allPairsCosts(bool withNextHops = false,
+                                ApspMethod method = ApspMethod::Auto) const;
+
+    /** return the worker threads used by parallel queries
+        created on first use with one thread per core */
+    ThreadPool& getThreadPool() const;
+
+    /** find the lowest cost path from start to end
+        runs a bidirectional Dijkstra search that stops as soon as the
+        forward and backward searches meet, so only the part of the graph
+        near the path is explored
+        uses A* with landmark bounds instead if buildLandmarks or
+        loadLandmarks was called since the graph last changed, and the
+        contraction hierarchy if buildContractionHierarchy was
+        stats, if given, receives the number of vertices settled */
+    PathResult shortestPath(const std::string& start,
+                            const std::string& end,
+                            QueryStats* stats = nullptr) const;
+
+    /** shortestPath with the result in the format of
+        djikstraCostToAllVertices, limited to the vertices on the path
+        weight has the cost to get to each of them, previous the vertex
+        before it; both are empty if end cannot be reached */
+    void shortestPath(const std::string& start, const std::string& end,
+                      std::map<std::string, int>& weight,
+                      std::map<std::string, std::string>& previous) const;
+
+    /** preprocessing for mostly static graphs, contract all vertices so
+        shortestPath only searches a few hundred of them
+        dropped by add and remove
+        return false if there are negative edge weights */
+    bool buildContractionHierarchy();
+
+    /** return true if shortestPath can use a contraction hierarchy */
+    bool hasContractionHierarchy() const;
+
+    /** preprocessing for shortestPath, choose count landmark vertices and
+        store the costs to and from each of them
+        dropped by add and remove, edge weights must not be negative */
+    void buildLandmarks(int count);
+
+    /** return true if shortestPath can use landmark bounds */
+    bool hasLandmarks() const;
+
+    /** write the landmark tables to a binary file
+        return false if there are none or the file could not be written */
+    bool saveLandmarks(const std::string& filename) const;
+
+    /** read landmark tables written by saveLandmarks
+        return false if the file could not be read or belongs to a
+        different graph */
+    bool loadLandmarks(const std::string& filename);
+
+    /** preprocessing for routing, find the weakly and strongly connected
+        components on getThreadPool, see Components; shortestPath then
+        answers at once when start and end are not connected
+        dropped by add and remove */
+    void buildComponents();
+
+    /** return the components found by buildComponents, nullptr if they
+        were not built; ids are those of getSnapshot */
+    std::shared_ptr<const Components> getComponents() const;
+
+    /** return true if start and end are in the same weakly connected
+        component, that is joined when edge directions are ignored;
+        if not, neither can be reached from the other
+        constant time after buildComponents, otherwise linear */
+    bool sameComponent(const std::string& start,
+                       const std::string& end) const;
+
+    /** return true if start and end are in the same strongly connected
+        component, so each can be reached from the other
+        constant time after buildComponents, otherwise linear */
+    bool sameStrongComponent(const std::string& start,
+                             const std::string& end) const;
+
+    /** build a compact, read-only copy of the graph
+        vertex ids follow the alphabetical order of the labels
+        later changes to the graph are not reflected in the copy */
+    CsrGraph freeze() const;
+
+    /** return a number that changes every time the graph does */
+    uint64_t getVersion() const;
+
+    /** return the compact copy of the graph used by shortest-path queries
+        built on first use and rebuilt after the graph changes
+        vertex ids follow getVertexOrder
+        the returned copy stays valid while the caller holds it */
+    std::shared_ptr<const CsrGraph> getSnapshot() const;
 
  private:
     /** number of vertices in graph */
@@ -76,19 +400,108 @@ class Graph {
     /** number of edges in graph */
     int numberOfEdges;
 
+    /** true if add, addEdges and readFile print the edges */
+    bool verbose;
+
+    /** vertex order of the snapshot */
+    VertexOrder vertexOrder;
+
+    /** receiver of the stats of each operation, may be nullptr */
+    StatsHook* statsHook;
+
+    /** raised by every change, see getVersion */
+    uint64_t version;
+
+    /** results of cachedShortestPathsFrom, by source */
+    mutable SsspCache ssspCache;
+
+    /** owns every vertex and the nodes of vertices and of each adjacency
+        list, declared before vertices so it outlives them */
+    NodePool pool;
+
     /** mapping from vertex label to vertex pointer for quick access */
-    std::map<std::string, Vertex*> vertices;
+    std::map<std::string, Vertex*, std::less<std::string>,
+             PoolAllocator<std::pair<const std::string, Vertex*>>> vertices;
+
+    /** every vertex, indexed by id */
+    std::vector<Vertex*> vertexById;
+
+    /** edges by vertex id, only kept while a source is tracked */
+    std::unique_ptr<IdAdjacency> idAdjacency;
+
+    /** shortest path trees of the tracked sources, by label */
+    std::map<std::string, std::unique_ptr<DynamicSssp>> trackedSources;
+
+    /** cached result of freeze, nullptr when out of date */
+    mutable std::shared_ptr<const CsrGraph> snapshot;
+
+    /** guards snapshot when several readers build it at once */
+    mutable std::mutex snapshotMutex;
+
+    /** workers for parallel queries, nullptr until first used */
+    mutable std::unique_ptr<ThreadPool> threadPool;
 
-    /** helper for depthFirstTraversal */
-    void depthFirstTraversalHelper(Vertex* startVertex,
-                                   void visit(const std::string&));
+    /** guards creation of threadPool */
+    mutable std::mutex threadPoolMutex;
 
-    /** helper for breadthFirstTraversal */
-    void breadthFirstTraversalHelper(Vertex*startVertex,
-                                     void visit(const std::string&));
+    /** contraction hierarchy for shortestPath, nullptr if not built */
+    std::shared_ptr<const ContractionHierarchy> hierarchy;
 
-    /** mark all verticies as unvisited */
-    void unvisitVertices();
+    /** landmark tables for shortestPath, nullptr if not built */
+    std::shared_ptr<const LandmarkIndex> landmarks;
+
+    /** components for shortestPath and sameComponent, nullptr if not
+        built */
+    std::shared_ptr<const Components> components;
+
+    /** what happened to an edge, see edgeChanged */
+    enum class EdgeChange { Added, Removed, Reweighted };
+
+    /** tell the tracked sources that the edge from -> to was added,
+        removed or reweighted from oldWeight to newWeight; an added edge
+        has newWeight and a removed one had oldWeight */
+    void edgeChanged(int from, int to, EdgeChange change, int oldWeight,
+                     int newWeight);
+
+    /** drop the cached compact copy and everything derived from it
+        after the graph changed, and raise the version
+        changedFrom, if given, is the only vertex whose edges changed,
+        cached results that do not reach it are kept */
+    void invalidateSnapshot(const std::string* changedFrom = nullptr);
+
+    /** helper for depthFirstTraversal, uses the stack in state
+        instead of recursion so long paths cannot overflow the call stack
+        return true if visit stopped the traversal */
+    template <class Visitor>
+    bool depthFirstTraversalHelper(const Vertex* startVertex, Visitor& visit,
+                                   TraversalState& state) const;
+
+    /** helper for breadthFirstTraversal
+        return true if visit stopped the traversal */
+    template <class Visitor>
+    bool breadthFirstTraversalHelper(const Vertex* startVertex,
+                                     Visitor& visit,
+                                     TraversalState& state) const;
+
+    /** call visit on label, return true if it asks to stop */
+    template <class Visitor>
+    static bool visitSaysStop(Visitor& visit, const std::string& label,
+                              std::true_type returnsVoid);
+
+    template <class Visitor>
+    static bool visitSaysStop(Visitor& visit, const std::string& label,
+                              std::false_type returnsVoid);
+
+    /** add the edge without printing it or dropping the snapshot
+        return false if it is a self-loop or already exists */
+    bool insertEdge(const std::string& start, const std::string& end,
+                    int edgeWeight);
+
+    /** construct a vertex in pool */
+    Vertex* createVertex(const std::string& vertexLabel, int id);
+
+    /** destroy every vertex and give its memory back to pool */
+    void destroyVertices();
 
     /** find a vertex, if it does not exist return nullptr */
     Vertex* findVertex(const std::string& vertexLabel) const;
@@ -97,4 +510,164 @@ class Graph {
     Vertex* findOrCreateVertex(const std::string& vertexLabel);
 };  // end Graph
 
+/** depth-first traversal calling visit(label) on each vertex
+    visit is any callable returning void or VisitResult
+    returns true if visit stopped the traversal
+    does nothing if startLabel is not in the graph */
+template <class Visitor>
+bool Graph::depthFirstTraversal(const std::string& startLabel,
+                                Visitor&& visit) const {
+    TraversalState state;
+    return depthFirstTraversal(startLabel, visit, state);
+}
+
+/** template depth-first traversal using the caller's state */
+template <class Visitor>
+bool Graph::depthFirstTraversal(const std::string& startLabel,
+                                Visitor&& visit,
+                                TraversalState& state) const {
+    state.reset(numberOfVertices);
+    StatsScope scope("depthFirstTraversal", statsHook, state.getStats());
+    if (kStatsEnabled) state.getStats().mapLookups++;
+    const Vertex* start = findVertex(startLabel);
+    if (start == nullptr) return false;
+    return depthFirstTraversalHelper(start, visit, state);
+}
+
+/** breadth-first traversal calling visit(label) on each vertex
+    visit is any callable returning void or VisitResult
+    returns true if visit stopped the traversal
+    does nothing if startLabel is not in the graph */
+template <class Visitor>
+bool Graph::breadthFirstTraversal(const std::string& startLabel,
+                                  Visitor&& visit) const {
+    TraversalState state;
+    return breadthFirstTraversal(startLabel, visit, state);
+}
+
+/** template breadth-first traversal using the caller's state */
+template <class Visitor>
+bool Graph::breadthFirstTraversal(const std::string& startLabel,
+                                  Visitor&& visit,
+                                  TraversalState& state) const {
+    state.reset(numberOfVertices);
+    StatsScope scope("breadthFirstTraversal", statsHook, state.getStats());
+    if (kStatsEnabled) state.getStats().mapLookups++;
+    const Vertex* start = findVertex(startLabel);
+    if (start == nullptr) return false;
+    return breadthFirstTraversalHelper(start, visit, state);
+}
+
+/** helper for depthFirstTraversal, uses the stack in state
+    instead of recursion so long paths cannot overflow the call stack
+    return true if visit stopped the traversal */
+template <class Visitor>
+bool Graph::depthFirstTraversalHelper(const Vertex* startVertex,
+                                      Visitor& visit,
+                                      TraversalState& state) const {
+    typedef decltype(visit(startVertex->getLabel())) Result;
+    std::vector<TraversalState::StackEntry>& stack = state.getStack();
+    QueryStats& stats = state.getStats();
+    stack.clear();
+    state.visit(startVertex->getId());
+    if (kStatsEnabled) stats.verticesSettled++;
+    if (visitSaysStop(visit, startVertex->getLabel(),
+                      std::is_void<Result>())) {
+        return true;
+    }
+    stack.push_back({ startVertex, startVertex->neighbors().begin() });
+
+    // the top entry resumes where the recursive version returned to
+    while (!stack.empty()) {
+        TraversalState::StackEntry& top = stack.back();
+        if (top.next == top.vertex->neighbors().end()) {
+            stack.pop_back();
+            continue;
+        }
+        const Vertex* next = vertices.at(top.next->getEndVertex());
+        ++top.next;
+        if (kStatsEnabled) {
+            stats.edgesRelaxed++;
+            stats.mapLookups++;
+        }
+        if (!state.isVisited(next->getId())) {
+            state.visit(next->getId());
+            if (kStatsEnabled) {
+                stats.verticesSettled++;
+                long long depth = static_cast<long long>(stack.size()) + 1;
+                if (depth > stats.peakFrontier) stats.peakFrontier = depth;
+            }
+            if (visitSaysStop(visit, next->getLabel(),
+                              std::is_void<Result>())) {
+                return true;
+            }
+            stack.push_back({ next, next->neighbors().begin() });
+        }
+    }
+    return false;
+}
+
+/** helper for breadthFirstTraversal
+    return true if visit stopped the traversal */
+template <class Visitor>
+bool Graph::breadthFirstTraversalHelper(const Vertex* startVertex,
+                                        Visitor& visit,
+                                        TraversalState& state) const {
+    typedef decltype(visit(startVertex->getLabel())) Result;
+    std::vector<const Vertex*>& queue = state.getQueue();
+    QueryStats& stats = state.getStats();
+    queue.clear();
+    // Mark the current node as visited and enqueue it
+    state.visit(startVertex->getId());
+    if (kStatsEnabled) stats.verticesSettled++;
+    if (visitSaysStop(visit, startVertex->getLabel(),
+                      std::is_void<Result>())) {
+        return true;
+    }
+    queue.push_back(startVertex);
+
+    for (size_t head = 0; head < queue.size(); ++head) {
+        // Get all adjacent vertices of the dequeued vertex. If an
+        // adjacent one has not been visited, mark it and enqueue it
+        for (const Edge& edge : queue[head]->neighbors()) {
+            const Vertex* temp = vertices.at(edge.getEndVertex());
+            if (kStatsEnabled) {
+                stats.edgesRelaxed++;
+                stats.mapLookups++;
+            }
+            if (!state.isVisited(temp->getId())) {
+                state.visit(temp->getId());
+                if (kStatsEnabled) {
+                    stats.verticesSettled++;
+                    long long waiting =
+                        static_cast<long long>(queue.size() - head);
+                    if (waiting > stats.peakFrontier) {
+                        stats.peakFrontier = waiting;
+                    }
+                }
+                if (visitSaysStop(visit, temp->getLabel(),
+                                  std::is_void<Result>())) {
+                    return true;
+                }
+                queue.push_back(temp);
+            }
+        }
+    }
+    return false;
+}
+
+/** call visit on label, return true if it asks to stop */
+template <class Visitor>
+bool Graph::visitSaysStop(Visitor& visit, const std::string& label,
+                          std::true_type) {
+    visit(label);
+    return false;
+}
+
+template <class Visitor>
+bool Graph::visitSaysStop(Visitor& visit, const std::string& label,
+                          std::false_type) {
+    return visit(label) == VisitResult::Stop;
+}
+
 #endif  // GRAPH_H
@@ -0,0 +1,204 @@
+#include <algorithm>
+#include <climits>
+#include <functional>
+
+#include "graphversion.h"
+#include "priorityqueues.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/** buckets of the label index before the first vertex */
+const size_t kFirstBuckets = 16;
+
+}  // namespace
+
+/** return the number of the version, 0 for the first */
+std::uint64_t GraphVersion::getVersion() const { return version; }
+
+/** return number of vertices */
+int GraphVersion::getNumVertices() const {
+    return static_cast<int>(labels.size());
+}
+
+/** return number of edges */
+int GraphVersion::getNumEdges() const { return numberOfEdges; }
+
+/** return the id of the vertex with the given label
+    returns -1 if the vertex does not exist */
+int GraphVersion::findVertex(const std::string& vertexLabel) const {
+    if (buckets.size() == 0) return -1;
+    for (int id : *buckets[bucketOf(vertexLabel)]) {
+        if (labels[id] == vertexLabel) return id;
+    }
+    return -1;
+}
+
+/** return the label of vertex id */
+const std::string& GraphVersion::getLabel(int id) const { return labels[id]; }
+
+/** edges leaving vertex id, in alphabetical order of end label */
+const std::vector<GraphVersion::Arc>& GraphVersion::outArcs(int id) const {
+    return *out[id];
+}
+
+/** return weight of the edge between start and end
+    returns INT_MAX if there is no such edge */
+int GraphVersion::getEdgeWeight(const std::string& start,
+                                const std::string& end) const {
+    int from = findVertex(start);
+    int to = findVertex(end);
+    if (from < 0 || to < 0) return INT_MAX;
+    for (const Arc& arc : outArcs(from)) {
+        if (arc.vertex == to) return arc.weight;
+    }
+    return INT_MAX;
+}
+
+/** return true if there is an edge from start to end, whatever its
+    weight, INT_MAX included */
+bool GraphVersion::hasEdge(const std::string& start,
+                           const std::string& end) const {
+    int from = findVertex(start);
+    int to = findVertex(end);
+    if (from < 0 || to < 0) return false;
+    for (const Arc& arc : outArcs(from)) {
+        if (arc.vertex == to) return true;
+    }
+    return false;
+}
+
+/** breadth-first traversal starting from startLabel
+    call the function visit on each vertex label
+    same visit order as Graph::breadthFirstTraversal */
+void GraphVersion::breadthFirstTraversal(
+    const std::string& startLabel, void visit(const std::string&)) const {
+    int start = findVertex(startLabel);
+    if (start < 0) return;
+
+    std::vector<char> visited(getNumVertices(), 0);
+    std::vector<int> queue;
+    visited[start] = 1;
+    visit(labels[start]);
+    queue.push_back(start);
+    for (size_t head = 0; head < queue.size(); ++head) {
+        for (const Arc& arc : outArcs(queue[head])) {
+            if (!visited[arc.vertex]) {
+                visited[arc.vertex] = 1;
+                visit(labels[arc.vertex]);
+                queue.push_back(arc.vertex);
+            }
+        }
+    }
+}
+
+/** find the lowest cost from startLabel to all vertices that can be
+    reached, same output format as Graph::djikstraCostToAllVertices
+    edge weights must not be negative */
+void GraphVersion::djikstraCostToAllVertices(
+    const std::string& startLabel,
+    std::map<std::string, int>& weight,
+    std::map<std::string, std::string>& previous) const {
+    weight.clear();
+    previous.clear();
+    int start = findVertex(startLabel);
+    if (start < 0) return;
+
+    int n = getNumVertices();
+    std::vector<int> distance(n, INT_MAX);
+    std::vector<int> predecessor(n, -1);
+    IndexedDaryHeap<4> heap;
+    heap.reserve(n);
+    distance[start] = 0;
+    heap.update(start, 0);
+    while (!heap.empty()) {
+        int v = heap.pop();
+        for (const Arc& arc : outArcs(v)) {
+            int cost = distance[v] + arc.weight;
+            if (cost < distance[arc.vertex]) {
+                distance[arc.vertex] = cost;
+                predecessor[arc.vertex] = v;
+                heap.update(arc.vertex, cost);
+            }
+        }
+    }
+    for (int v = 0; v < n; ++v) {
+        if (v == start || distance[v] == INT_MAX) continue;
+        weight[labels[v]] = distance[v];
+        previous[labels[v]] = labels[predecessor[v]];
+    }
+}
+
+/** bucket of label */
+size_t GraphVersion::bucketOf(const std::string& vertexLabel) const {
+    return std::hash<std::string>()(vertexLabel) & (buckets.size() - 1);
+}
+
+/** find a vertex, if it does not exist create it and return its id
+    only for versions that are not published yet */
+int GraphVersion::findOrAddVertex(const std::string& vertexLabel) {
+    int id = findVertex(vertexLabel);
+    if (id >= 0) return id;
+
+    id = getNumVertices();
+    labels.push_back(vertexLabel);
+    out.push_back(std::make_shared<const std::vector<Arc>>());
+    if (labels.size() > buckets.size()) {
+        // one vertex per bucket on average, rebuilt at twice the size
+        size_t count = std::max(kFirstBuckets, buckets.size() * 2);
+        std::vector<std::vector<int>> fresh(count);
+        for (size_t v = 0; v < labels.size(); ++v) {
+            fresh[std::hash<std::string>()(labels[v]) & (count - 1)]
+                .push_back(static_cast<int>(v));
+        }
+        buckets = CowArray<Bucket>();
+        for (std::vector<int>& ids : fresh) {
+            buckets.push_back(
+                std::make_shared<const std::vector<int>>(std::move(ids)));
+        }
+    } else {
+        size_t b = bucketOf(vertexLabel);
+        auto ids = std::make_shared<std::vector<int>>(*buckets[b]);
+        ids->push_back(id);
+        buckets.set(b, std::move(ids));
+    }
+    return id;
+}
+
+/** set the weight of the edge from -> to, adding it if missing
+    return the old weight, INT_MAX if the edge is new
+    only for versions that are not published yet */
+int GraphVersion::setArc(int from, int to, int weight) {
+    auto arcs = std::make_shared<std::vector<Arc>>(*out[from]);
+    auto it = std::lower_bound(arcs->begin(), arcs->end(), labels[to],
+        [this](const Arc& arc, const std::string& label) {
+            return labels[arc.vertex] < label;
+        });
+    int oldWeight = INT_MAX;
+    if (it != arcs->end() && it->vertex == to) {
+        oldWeight = it->weight;
+        it->weight = weight;
+    } else {
+        arcs->insert(it, { to, weight });
+        numberOfEdges++;
+    }
+    out.set(from, std::move(arcs));
+    return oldWeight;
+}
+
+/** remove the edge from -> to, return false if there is none
+    only for versions that are not published yet */
+bool GraphVersion::removeArc(int from, int to) {
+    const std::vector<Arc>& old = *out[from];
+    auto it = std::find_if(old.begin(), old.end(),
+                           [to](const Arc& arc) { return arc.vertex == to; });
+    if (it == old.end()) return false;
+    auto arcs = std::make_shared<std::vector<Arc>>(old.begin(), it);
+    arcs->insert(arcs->end(), it + 1, old.end());
+    out.set(from, std::move(arcs));
+    numberOfEdges--;
+    return true;
+}
@@ -0,0 +1,109 @@
+/**
+ * One immutable version of a VersionedGraph
+ * Readers get a version as a shared_ptr from VersionedGraph::snapshot
+ * and can query it without locks for as long as they hold it, while
+ * writers publish newer versions; the version and whatever it alone
+ * uses are freed when the last holder lets go
+ * Vertices get ids in order of creation; each vertex has its own
+ * shared list of outgoing edges, sorted alphabetically by the label of
+ * the end vertex like Vertex, so a new version copies only the lists
+ * it changes. Labels are found through a hash index of shared buckets
+ */
+
+#ifndef GRAPHVERSION_H
+#define GRAPHVERSION_H
+
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "cowarray.h"
+
+class GraphVersion {
+    friend class VersionedGraph;
+
+ public:
+    /** end vertex of an edge and its weight */
+    struct Arc {
+        int vertex;
+        int weight;
+    };
+
+    /** return the number of the version, 0 for the first */
+    std::uint64_t getVersion() const;
+
+    /** return number of vertices */
+    int getNumVertices() const;
+
+    /** return number of edges */
+    int getNumEdges() const;
+
+    /** return the id of the vertex with the given label
+        returns -1 if the vertex does not exist */
+    int findVertex(const std::string& vertexLabel) const;
+
+    /** return the label of vertex id */
+    const std::string& getLabel(int id) const;
+
+    /** edges leaving vertex id, in alphabetical order of end label */
+    const std::vector<Arc>& outArcs(int id) const;
+
+    /** return weight of the edge between start and end
+        returns INT_MAX if there is no such edge */
+    int getEdgeWeight(const std::string& start, const std::string& end) const;
+
+    /** return true if there is an edge from start to end, whatever its
+        weight, INT_MAX included */
+    bool hasEdge(const std::string& start, const std::string& end) const;
+
+    /** breadth-first traversal starting from startLabel
+        call the function visit on each vertex label
+        same visit order as Graph::breadthFirstTraversal */
+    void breadthFirstTraversal(const std::string& startLabel,
+                               void visit(const std::string&)) const;
+
+    /** find the lowest cost from startLabel to all vertices that can be
+        reached, same output format as Graph::djikstraCostToAllVertices
+        edge weights must not be negative */
+    void djikstraCostToAllVertices(
+        const std::string& startLabel,
+        std::map<std::string, int>& weight,
+        std::map<std::string, std::string>& previous) const;
+
+ private:
+    typedef std::shared_ptr<const std::vector<Arc>> ArcList;
+    typedef std::shared_ptr<const std::vector<int>> Bucket;
+
+    std::uint64_t version {0};
+    int numberOfEdges {0};
+
+    /** label of each vertex, by id */
+    CowArray<std::string> labels;
+
+    /** outgoing edges of each vertex, by id */
+    CowArray<ArcList> out;
+
+    /** ids of the vertices whose label hashes to each bucket,
+        the number of buckets is a power of two */
+    CowArray<Bucket> buckets;
+
+    /** bucket of label */
+    size_t bucketOf(const std::string& vertexLabel) const;
+
+    /** find a vertex, if it does not exist create it and return its id
+        only for versions that are not published yet */
+    int findOrAddVertex(const std::string& vertexLabel);
+
+    /** set the weight of the edge from -> to, adding it if missing
+        return the old weight, INT_MAX if the edge is new
+        only for versions that are not published yet */
+    int setArc(int from, int to, int weight);
+
+    /** remove the edge from -> to, return false if there is none
+        only for versions that are not published yet */
+    bool removeArc(int from, int to);
+};  // end GraphVersion
+
+#endif  // GRAPHVERSION_H
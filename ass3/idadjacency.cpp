@@ -0,0 +1,60 @@
+#include <cstddef>
+
+#include "idadjacency.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+/** add a vertex without edges, return its id */
+int IdAdjacency::addVertex() {
+    out.emplace_back();
+    in.emplace_back();
+    return static_cast<int>(out.size()) - 1;
+}
+
+/** return number of vertices */
+int IdAdjacency::getNumVertices() const {
+    return static_cast<int>(out.size());
+}
+
+/** add the edge from -> to, which must not exist yet */
+void IdAdjacency::addEdge(int from, int to, int weight) {
+    out[from].push_back({ to, weight });
+    in[to].push_back({ from, weight });
+}
+
+/** set the weight of the edge from -> to, adding it if missing */
+void IdAdjacency::setEdge(int from, int to, int weight) {
+    setArc(out[from], to, weight);
+    setArc(in[to], from, weight);
+}
+
+/** remove the edge from -> to, if there is one */
+void IdAdjacency::removeEdge(int from, int to) {
+    removeArc(out[from], to);
+    removeArc(in[to], from);
+}
+
+/** set or add the arc to vertex in arcs */
+void IdAdjacency::setArc(std::vector<Arc>& arcs, int vertex, int weight) {
+    for (Arc& arc : arcs) {
+        if (arc.vertex == vertex) {
+            arc.weight = weight;
+            return;
+        }
+    }
+    arcs.push_back({ vertex, weight });
+}
+
+/** remove the arc to vertex from arcs */
+void IdAdjacency::removeArc(std::vector<Arc>& arcs, int vertex) {
+    for (size_t i = 0; i < arcs.size(); ++i) {
+        if (arcs[i].vertex == vertex) {
+            // order does not matter, fill the hole with the last arc
+            arcs[i] = arcs.back();
+            arcs.pop_back();
+            return;
+        }
+    }
+}
@@ -0,0 +1,54 @@
+/**
+ * Edges of a graph by vertex id, both outgoing and incoming
+ * Unlike CsrGraph it can be changed one edge at a time, so structures
+ * that follow a changing Graph, like DynamicSssp, can read it while
+ * Graph keeps it in step with add, remove and setEdgeWeight
+ * Edges of a vertex are kept in no particular order
+ */
+
+#ifndef IDADJACENCY_H
+#define IDADJACENCY_H
+
+#include <vector>
+
+class IdAdjacency {
+ public:
+    /** one end of an edge and its weight */
+    struct Arc {
+        int vertex;
+        int weight;
+    };
+
+    /** add a vertex without edges, return its id */
+    int addVertex();
+
+    /** return number of vertices */
+    int getNumVertices() const;
+
+    /** add the edge from -> to, which must not exist yet */
+    void addEdge(int from, int to, int weight);
+
+    /** set the weight of the edge from -> to, adding it if missing */
+    void setEdge(int from, int to, int weight);
+
+    /** remove the edge from -> to, if there is one */
+    void removeEdge(int from, int to);
+
+    /** edges leaving vertex id, Arc::vertex is the end vertex */
+    const std::vector<Arc>& outArcs(int id) const { return out[id]; }
+
+    /** edges arriving at vertex id, Arc::vertex is the start vertex */
+    const std::vector<Arc>& inArcs(int id) const { return in[id]; }
+
+ private:
+    std::vector<std::vector<Arc>> out;
+    std::vector<std::vector<Arc>> in;
+
+    /** set or add the arc to vertex in arcs */
+    static void setArc(std::vector<Arc>& arcs, int vertex, int weight);
+
+    /** remove the arc to vertex from arcs */
+    static void removeArc(std::vector<Arc>& arcs, int vertex);
+};  // end IdAdjacency
+
+#endif  // IDADJACENCY_H
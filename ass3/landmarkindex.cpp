@@ -0,0 +1,175 @@
+#include <climits>
+#include <fstream>
+
+#include "dijkstraengine.h"
+#include "landmarkindex.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/** file tag, the digit is the format version */
+const char kMagic[4] = { 'A', 'L', 'T', '1' };
+
+}  // namespace
+
+/** constructor, no landmarks */
+LandmarkIndex::LandmarkIndex() : numVertices(0), graphFingerprint(0) {}
+
+/** choose count landmarks far apart from each other and compute
+    their distance tables, 2 * count Dijkstra runs
+    edge weights must not be negative */
+void LandmarkIndex::build(const CsrGraph& graph, int count) {
+    int n = graph.getNumVertices();
+    numVertices = n;
+    graphFingerprint = graph.fingerprint();
+    landmarks.clear();
+    if (count > n) count = n;
+    if (count < 0) count = 0;
+
+    // round trip cost to the closest landmark, INT_MAX parts count as huge
+    // so vertices no landmark can reach are picked first
+    const long long kFar = 1LL << 40;
+    std::vector<long long> closest(n, LLONG_MAX);
+    std::vector<int> from(static_cast<size_t>(n) * count);
+    std::vector<int> to(static_cast<size_t>(n) * count);
+    DijkstraEngine engine;
+
+    // start from the vertex farthest from vertex 0
+    int next = 0;
+    if (n > 0 && count > 0) {
+        engine.run(graph, 0);
+        const std::vector<int>& dist = engine.getDistances();
+        for (int v = 0; v < n; ++v) {
+            if (dist[v] != INT_MAX && dist[v] > dist[next]) next = v;
+        }
+    }
+
+    for (int i = 0; i < count; ++i) {
+        landmarks.push_back(next);
+        engine.run(graph, next);
+        for (int v = 0; v < n; ++v) {
+            from[static_cast<size_t>(v) * count + i] =
+                engine.getDistances()[v];
+        }
+        engine.runReverse(graph, next);
+        for (int v = 0; v < n; ++v) {
+            to[static_cast<size_t>(v) * count + i] = engine.getDistances()[v];
+        }
+
+        // the next landmark is the vertex farthest from all chosen ones
+        long long farthest = -1;
+        for (int v = 0; v < n; ++v) {
+            int a = from[static_cast<size_t>(v) * count + i];
+            int b = to[static_cast<size_t>(v) * count + i];
+            long long round = (a == INT_MAX ? kFar : a) +
+                (b == INT_MAX ? kFar : b);
+            if (round < closest[v]) closest[v] = round;
+            if (closest[v] > farthest) {
+                farthest = closest[v];
+                next = v;
+            }
+        }
+    }
+    fromLandmark.swap(from);
+    toLandmark.swap(to);
+}
+
+/** return number of landmarks */
+int LandmarkIndex::getNumLandmarks() const {
+    return static_cast<int>(landmarks.size());
+}
+
+/** return the vertex ids chosen as landmarks */
+const std::vector<int>& LandmarkIndex::getLandmarks() const {
+    return landmarks;
+}
+
+/** return true if the tables were built for this graph */
+bool LandmarkIndex::matches(const CsrGraph& graph) const {
+    return numVertices == graph.getNumVertices() &&
+        graphFingerprint == graph.fingerprint();
+}
+
+/** lower bound on the cost from v to target
+    INT_MAX if v certainly cannot reach target */
+int LandmarkIndex::lowerBound(int v, int target) const {
+    size_t k = landmarks.size();
+    const int* fromV = fromLandmark.data() + v * k;
+    const int* fromT = fromLandmark.data() + target * k;
+    const int* toV = toLandmark.data() + v * k;
+    const int* toT = toLandmark.data() + target * k;
+    int bound = 0;
+    for (size_t i = 0; i < k; ++i) {
+        if (toT[i] != INT_MAX) {
+            // t reaches L but v does not, so v cannot reach t either
+            if (toV[i] == INT_MAX) return INT_MAX;
+            if (toV[i] - toT[i] > bound) bound = toV[i] - toT[i];
+        }
+        if (fromV[i] != INT_MAX && fromT[i] != INT_MAX &&
+            fromT[i] - fromV[i] > bound) {
+            bound = fromT[i] - fromV[i];
+        }
+    }
+    return bound;
+}
+
+/** write the tables to a binary file
+    return false if the file could not be written */
+bool LandmarkIndex::save(const std::string& filename) const {
+    std::ofstream out(filename, std::ios::binary);
+    if (!out) return false;
+    int k = getNumLandmarks();
+    out.write(kMagic, sizeof(kMagic));
+    out.write(reinterpret_cast<const char*>(&numVertices), sizeof(int));
+    out.write(reinterpret_cast<const char*>(&k), sizeof(int));
+    out.write(reinterpret_cast<const char*>(&graphFingerprint),
+              sizeof(graphFingerprint));
+    out.write(reinterpret_cast<const char*>(landmarks.data()),
+              k * sizeof(int));
+    out.write(reinterpret_cast<const char*>(fromLandmark.data()),
+              fromLandmark.size() * sizeof(int));
+    out.write(reinterpret_cast<const char*>(toLandmark.data()),
+              toLandmark.size() * sizeof(int));
+    return static_cast<bool>(out);
+}
+
+/** read tables written by save
+    return false if the file could not be read or was built for a
+    different graph, the index is then left unchanged */
+bool LandmarkIndex::load(const std::string& filename,
+                         const CsrGraph& graph) {
+    std::ifstream in(filename, std::ios::binary);
+    if (!in) return false;
+    char magic[sizeof(kMagic)];
+    int n = 0;
+    int k = 0;
+    std::uint64_t fingerprint = 0;
+    in.read(magic, sizeof(magic));
+    in.read(reinterpret_cast<char*>(&n), sizeof(int));
+    in.read(reinterpret_cast<char*>(&k), sizeof(int));
+    in.read(reinterpret_cast<char*>(&fingerprint), sizeof(fingerprint));
+    if (!in || std::string(magic, sizeof(magic)) !=
+        std::string(kMagic, sizeof(kMagic)) ||
+        n != graph.getNumVertices() || k < 0 || k > n ||
+        fingerprint != graph.fingerprint()) {
+        return false;
+    }
+
+    std::vector<int> chosen(k);
+    std::vector<int> from(static_cast<size_t>(n) * k);
+    std::vector<int> to(static_cast<size_t>(n) * k);
+    in.read(reinterpret_cast<char*>(chosen.data()), k * sizeof(int));
+    in.read(reinterpret_cast<char*>(from.data()), from.size() * sizeof(int));
+    in.read(reinterpret_cast<char*>(to.data()), to.size() * sizeof(int));
+    if (!in) return false;
+
+    numVertices = n;
+    graphFingerprint = fingerprint;
+    landmarks.swap(chosen);
+    fromLandmark.swap(from);
+    toLandmark.swap(to);
+    return true;
+}
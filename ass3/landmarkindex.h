@@ -0,0 +1,72 @@
+/**
+ * Landmark distance tables for A* search (ALT: A*, landmarks and the
+ * triangle inequality)
+ * A few landmark vertices are chosen and the exact costs from every
+ * landmark to every vertex, and from every vertex to every landmark, are
+ * stored. For any vertices v and t and landmark L
+ *     d(v, t) >= d(v, L) - d(t, L)   and   d(v, t) >= d(L, t) - d(L, v)
+ * which gives A* a lower bound on the remaining cost
+ * Tables are only valid for the graph they were built from, save and
+ * load check this with CsrGraph::fingerprint
+ */
+
+#ifndef LANDMARKINDEX_H
+#define LANDMARKINDEX_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "csrgraph.h"
+
+class LandmarkIndex {
+ public:
+    /** constructor, no landmarks */
+    LandmarkIndex();
+
+    /** choose count landmarks far apart from each other and compute
+        their distance tables, 2 * count Dijkstra runs
+        edge weights must not be negative */
+    void build(const CsrGraph& graph, int count);
+
+    /** return number of landmarks */
+    int getNumLandmarks() const;
+
+    /** return the vertex ids chosen as landmarks */
+    const std::vector<int>& getLandmarks() const;
+
+    /** return true if the tables were built for this graph */
+    bool matches(const CsrGraph& graph) const;
+
+    /** lower bound on the cost from v to target
+        INT_MAX if v certainly cannot reach target */
+    int lowerBound(int v, int target) const;
+
+    /** write the tables to a binary file
+        return false if the file could not be written */
+    bool save(const std::string& filename) const;
+
+    /** read tables written by save
+        return false if the file could not be read or was built for a
+        different graph, the index is then left unchanged */
+    bool load(const std::string& filename, const CsrGraph& graph);
+
+ private:
+    /** number of vertices of the graph the tables belong to */
+    int numVertices;
+
+    /** CsrGraph::fingerprint of that graph */
+    std::uint64_t graphFingerprint;
+
+    /** landmark vertex ids */
+    std::vector<int> landmarks;
+
+    /** cost from landmark i to v at [v * k + i], INT_MAX if unreachable
+        stored by vertex so the k entries of one vertex are adjacent */
+    std::vector<int> fromLandmark;
+
+    /** cost from v to landmark i at [v * k + i], INT_MAX if unreachable */
+    std::vector<int> toLandmark;
+};  // end LandmarkIndex
+
+#endif  // LANDMARKINDEX_H
@@ -0,0 +1,108 @@
+#ifdef _WIN32
+#define WIN32_LEAN_AND_MEAN
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#include "mappedfile.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+/** constructor, no file */
+#ifdef _WIN32
+MappedFile::MappedFile()
+    : bytes(nullptr), length(0), opened(false), file(INVALID_HANDLE_VALUE),
+      mapping(nullptr) {}
+#else
+MappedFile::MappedFile() : bytes(nullptr), length(0), opened(false) {}
+#endif
+
+/** destructor, unmaps the file */
+MappedFile::~MappedFile() { close(); }
+
+/** map the file, closing any file mapped before
+    return false if it cannot be opened or mapped */
+bool MappedFile::open(const std::string& filename) {
+    close();
+#ifdef _WIN32
+    HANDLE handle = CreateFileA(filename.c_str(), GENERIC_READ,
+                                FILE_SHARE_READ, nullptr, OPEN_EXISTING,
+                                FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (handle == INVALID_HANDLE_VALUE) return false;
+    LARGE_INTEGER fileSize;
+    if (!GetFileSizeEx(handle, &fileSize)) {
+        CloseHandle(handle);
+        return false;
+    }
+    file = handle;
+    length = static_cast<std::size_t>(fileSize.QuadPart);
+    if (length > 0) {
+        // a file mapping cannot be created for an empty file
+        mapping = CreateFileMappingA(handle, nullptr, PAGE_READONLY, 0, 0,
+                                     nullptr);
+        if (mapping != nullptr) {
+            bytes = static_cast<const char*>(
+                MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0));
+        }
+        if (bytes == nullptr) {
+            close();
+            return false;
+        }
+    }
+#else
+    int descriptor = ::open(filename.c_str(), O_RDONLY);
+    if (descriptor < 0) return false;
+    struct stat status;
+    if (fstat(descriptor, &status) != 0 || !S_ISREG(status.st_mode)) {
+        ::close(descriptor);
+        return false;
+    }
+    length = static_cast<std::size_t>(status.st_size);
+    if (length > 0) {
+        void* view = mmap(nullptr, length, PROT_READ, MAP_PRIVATE,
+                          descriptor, 0);
+        if (view == MAP_FAILED) {
+            ::close(descriptor);
+            length = 0;
+            return false;
+        }
+        madvise(view, length, MADV_SEQUENTIAL);
+        bytes = static_cast<const char*>(view);
+    }
+    // the mapping stays valid after the descriptor is closed
+    ::close(descriptor);
+#endif
+    opened = true;
+    return true;
+}
+
+/** unmap the file */
+void MappedFile::close() {
+#ifdef _WIN32
+    if (bytes != nullptr) UnmapViewOfFile(bytes);
+    if (mapping != nullptr) CloseHandle(mapping);
+    if (file != INVALID_HANDLE_VALUE) CloseHandle(file);
+    mapping = nullptr;
+    file = INVALID_HANDLE_VALUE;
+#else
+    if (bytes != nullptr) munmap(const_cast<char*>(bytes), length);
+#endif
+    bytes = nullptr;
+    length = 0;
+    opened = false;
+}
+
+/** return true if a file is mapped */
+bool MappedFile::isOpen() const { return opened; }
+
+/** first byte of the file, nullptr if it is empty */
+const char* MappedFile::data() const { return bytes; }
+
+/** number of bytes in the file */
+std::size_t MappedFile::size() const { return length; }
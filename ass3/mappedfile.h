@@ -0,0 +1,59 @@
+/**
+ * Read-only view of a whole file mapped into memory
+ * Uses mmap on POSIX systems and a file mapping on Windows, so the
+ * bytes are paged in by the operating system as they are read instead
+ * of being copied through a stream buffer
+ * The mapping is released by close or the destructor
+ */
+
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <cstddef>
+#include <string>
+
+class MappedFile {
+ public:
+    /** constructor, no file */
+    MappedFile();
+
+    /** destructor, unmaps the file */
+    ~MappedFile();
+
+    MappedFile(const MappedFile&) = delete;
+    MappedFile& operator=(const MappedFile&) = delete;
+
+    /** map the file, closing any file mapped before
+        return false if it cannot be opened or mapped */
+    bool open(const std::string& filename);
+
+    /** unmap the file */
+    void close();
+
+    /** return true if a file is mapped */
+    bool isOpen() const;
+
+    /** first byte of the file, nullptr if it is empty */
+    const char* data() const;
+
+    /** number of bytes in the file */
+    std::size_t size() const;
+
+ private:
+    /** mapped bytes, nullptr if none */
+    const char* bytes;
+
+    /** length of the mapping */
+    std::size_t length;
+
+    /** true between a successful open and close */
+    bool opened;
+
+#ifdef _WIN32
+    /** file and mapping handles */
+    void* file;
+    void* mapping;
+#endif
+};  // end MappedFile
+
+#endif  // MAPPEDFILE_H
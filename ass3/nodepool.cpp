@@ -0,0 +1,76 @@
+#include "nodepool.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/** size of each block, large enough that the list of blocks stays short */
+const std::size_t kBlockSize = 256 * 1024;
+
+/** size rounded up to the next multiple of 8 */
+std::size_t roundUp(std::size_t size) { return (size + 7) & ~std::size_t(7); }
+
+}  // namespace
+
+/** constructor, no blocks yet */
+NodePool::NodePool()
+    : cursor(nullptr), blockEnd(nullptr), bytesInUse(0), bytesReserved(0) {
+    for (FreeNode*& list : freeLists) {
+        list = nullptr;
+    }
+}
+
+/** destructor, releases every block */
+NodePool::~NodePool() {
+    for (char* block : blocks) {
+        ::operator delete(block);
+    }
+}
+
+/** return size bytes aligned to 8, sizes above kMaxNode bytes
+    go to operator new */
+void* NodePool::allocate(std::size_t size) {
+    size = roundUp(size == 0 ? 1 : size);
+    bytesInUse += size;
+    if (size > kMaxNode) return ::operator new(size);
+
+    FreeNode*& list = freeLists[size / 8];
+    if (list != nullptr) {
+        FreeNode* node = list;
+        list = node->next;
+        return node;
+    }
+    if (static_cast<std::size_t>(blockEnd - cursor) < size) {
+        // the tail of the old block is too small for this size, it is
+        // left unused rather than split over the free lists
+        char* block = static_cast<char*>(::operator new(kBlockSize));
+        blocks.push_back(block);
+        bytesReserved += kBlockSize;
+        cursor = block;
+        blockEnd = block + kBlockSize;
+    }
+    void* node = cursor;
+    cursor += size;
+    return node;
+}
+
+/** give back memory from allocate with the same size */
+void NodePool::deallocate(void* node, std::size_t size) {
+    size = roundUp(size == 0 ? 1 : size);
+    bytesInUse -= size;
+    if (size > kMaxNode) {
+        ::operator delete(node);
+        return;
+    }
+    FreeNode* freed = static_cast<FreeNode*>(node);
+    freed->next = freeLists[size / 8];
+    freeLists[size / 8] = freed;
+}
+
+/** bytes handed out by allocate and not given back */
+std::size_t NodePool::getBytesInUse() const { return bytesInUse; }
+
+/** bytes held in blocks, used or not */
+std::size_t NodePool::getBytesReserved() const { return bytesReserved; }
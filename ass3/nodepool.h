@@ -0,0 +1,111 @@
+/**
+ * Memory pool for the small, fixed-size nodes of the graph containers
+ * Carves allocations out of large blocks and keeps freed nodes on one
+ * free list per size, so vertices and map nodes cost no malloc header
+ * and are packed next to each other
+ * All blocks are released at once when the pool is destroyed
+ * PoolAllocator plugs a pool into the standard containers
+ * A pool is not thread safe, same as the containers using it
+ */
+
+#ifndef NODEPOOL_H
+#define NODEPOOL_H
+
+#include <cstddef>
+#include <new>
+#include <vector>
+
+class NodePool {
+ public:
+    /** constructor, no blocks yet */
+    NodePool();
+
+    /** destructor, releases every block */
+    ~NodePool();
+
+    NodePool(const NodePool&) = delete;
+    NodePool& operator=(const NodePool&) = delete;
+
+    /** return size bytes aligned to 8, sizes above kMaxNode bytes
+        go to operator new */
+    void* allocate(std::size_t size);
+
+    /** give back memory from allocate with the same size */
+    void deallocate(void* node, std::size_t size);
+
+    /** bytes handed out by allocate and not given back */
+    std::size_t getBytesInUse() const;
+
+    /** bytes held in blocks, used or not */
+    std::size_t getBytesReserved() const;
+
+    /** largest size served from the blocks */
+    static const std::size_t kMaxNode = 256;
+
+ private:
+    /** freed node, linked through its first bytes */
+    struct FreeNode {
+        FreeNode* next;
+    };
+
+    /** free list for each multiple of 8 up to kMaxNode */
+    FreeNode* freeLists[kMaxNode / 8 + 1];
+
+    /** every block, released by the destructor */
+    std::vector<char*> blocks;
+
+    /** unused part of the newest block */
+    char* cursor;
+    char* blockEnd;
+
+    std::size_t bytesInUse;
+    std::size_t bytesReserved;
+};  // end NodePool
+
+/** standard allocator drawing from a NodePool
+    without a pool it uses operator new, so containers work on their own */
+template <class T>
+class PoolAllocator {
+ public:
+    typedef T value_type;
+
+    PoolAllocator() noexcept : pool(nullptr) {}
+
+    explicit PoolAllocator(NodePool* pool) noexcept : pool(pool) {}
+
+    template <class U>
+    PoolAllocator(const PoolAllocator<U>& other) noexcept
+        : pool(other.getPool()) {}
+
+    T* allocate(std::size_t n) {
+        static_assert(alignof(T) <= 8, "NodePool aligns to 8 bytes");
+        std::size_t size = n * sizeof(T);
+        return static_cast<T*>(pool != nullptr ? pool->allocate(size)
+                                               : ::operator new(size));
+    }
+
+    void deallocate(T* node, std::size_t n) {
+        if (pool != nullptr) {
+            pool->deallocate(node, n * sizeof(T));
+        } else {
+            ::operator delete(node);
+        }
+    }
+
+    NodePool* getPool() const { return pool; }
+
+    template <class U>
+    bool operator==(const PoolAllocator<U>& other) const {
+        return pool == other.getPool();
+    }
+
+    template <class U>
+    bool operator!=(const PoolAllocator<U>& other) const {
+        return pool != other.getPool();
+    }
+
+ private:
+    NodePool* pool;
+};  // end PoolAllocator
+
+#endif  // NODEPOOL_H
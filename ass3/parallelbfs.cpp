@@ -0,0 +1,191 @@
+#include <algorithm>
+#include <climits>
+
+#include "parallelbfs.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/** go bottom-up once the frontier has more than 1/kAlpha of the edges
+    still to be checked, back top-down once it has fewer than 1/kBeta
+    of the vertices; the values suggested by Beamer et al. */
+const long long kAlpha = 14;
+const long long kBeta = 24;
+
+/** frontier vertices per chunk handed to a thread in top-down steps */
+const int kGrain = 256;
+
+/** bitmap words per chunk in bottom-up steps */
+const int kWordGrain = 16;
+
+/** lower word to value if that is smaller, return the value before */
+int fetchMin(std::atomic<int>& word, int value) {
+    int seen = word.load(std::memory_order_relaxed);
+    while (value < seen &&
+           !word.compare_exchange_weak(seen, value,
+                                       std::memory_order_relaxed)) {
+    }
+    return seen;
+}
+
+}  // namespace
+
+/** constructor, the levels are expanded on pool */
+ParallelBfs::ParallelBfs(ThreadPool& pool) : pool(pool), bottomUpSteps(0) {}
+
+/** search from source
+    ordered makes parents and getOrder follow the sequential visit
+    order; bottom-up steps then read all incoming edges of a vertex
+    instead of stopping at the first parent */
+void ParallelBfs::run(const CsrGraph& graph, int source, bool ordered) {
+    int n = graph.getNumVertices();
+    depth.assign(n, -1);
+    parent.assign(n, -1);
+    order.clear();
+    bottomUpSteps = 0;
+    if (source < 0 || source >= n) return;
+
+    if (static_cast<int>(claim.size()) != n) {
+        std::vector<std::atomic<int>> fresh(n);
+        claim.swap(fresh);
+    }
+    for (int v = 0; v < n; ++v) {
+        claim[v].store(INT_MAX, std::memory_order_relaxed);
+    }
+    reached.assign(pool.getNumThreads(), std::vector<int>());
+    order.reserve(n);
+
+    if (ordered) position.assign(n, -1);
+    depth[source] = 0;
+    order.push_back(source);
+    if (ordered) position[source] = 0;
+    // incoming edges of unvisited vertices, the work of a bottom-up step
+    long long unexplored = graph.getNumEdges() -
+        (graph.inEdgeEnd(source) - graph.inEdgeBegin(source));
+    long long frontierEdges = graph.edgeEnd(source) - graph.edgeBegin(source);
+    bool goingUp = false;
+
+    for (int begin = 0, level = 0; begin < static_cast<int>(order.size());
+         ++level) {
+        int end = static_cast<int>(order.size());
+        if (!goingUp && frontierEdges > unexplored / kAlpha) {
+            goingUp = true;
+        } else if (goingUp && end - begin < n / kBeta) {
+            goingUp = false;
+        }
+        if (goingUp) {
+            bottomUp(graph, begin, end, ordered);
+            ++bottomUpSteps;
+        } else {
+            topDown(graph, begin, end, ordered);
+        }
+
+        // the next level, sorted so the result is the same every time
+        for (std::vector<int>& mine : reached) {
+            order.insert(order.end(), mine.begin(), mine.end());
+            mine.clear();
+        }
+        auto next = order.begin() + end;
+        if (ordered) {
+            // by parent, then by id, the order of the parent's edges
+            std::sort(next, order.end(), [this](int a, int b) {
+                int byParent = claim[a].load(std::memory_order_relaxed) -
+                    claim[b].load(std::memory_order_relaxed);
+                return byParent != 0 ? byParent < 0 : a < b;
+            });
+        } else {
+            std::sort(next, order.end());
+        }
+        frontierEdges = 0;
+        for (int i = end; i < static_cast<int>(order.size()); ++i) {
+            int u = order[i];
+            int key = claim[u].load(std::memory_order_relaxed);
+            depth[u] = level + 1;
+            if (ordered) {
+                parent[u] = order[key];
+                position[u] = i;
+            } else {
+                parent[u] = key;
+            }
+            frontierEdges += graph.edgeEnd(u) - graph.edgeBegin(u);
+            unexplored -= graph.inEdgeEnd(u) - graph.inEdgeBegin(u);
+        }
+        begin = end;
+    }
+}
+
+/** hops from the last source, -1 if unreachable */
+const std::vector<int>& ParallelBfs::getDepths() const { return depth; }
+
+/** vertex before each vertex on its shortest path, -1 if none */
+const std::vector<int>& ParallelBfs::getParents() const { return parent; }
+
+/** reached vertices level by level
+    in visit order if run was ordered, else by id within a level */
+const std::vector<int>& ParallelBfs::getOrder() const { return order; }
+
+/** number of levels of the last run expanded bottom-up */
+int ParallelBfs::getBottomUpSteps() const { return bottomUpSteps; }
+
+/** claim the unvisited targets of frontier order[begin..end-1] */
+void ParallelBfs::topDown(const CsrGraph& graph, int begin, int end,
+                          bool ordered) {
+    pool.parallelFor(begin, end, kGrain,
+        [&](int first, int last, int thread) {
+        std::vector<int>& mine = reached[thread];
+        for (int i = first; i < last; ++i) {
+            int v = order[i];
+            int key = ordered ? i : v;
+            for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+                int u = graph.edgeTarget(e);
+                // depth is only written between steps
+                if (depth[u] >= 0) continue;
+                // whoever claims u first lists it, once
+                if (fetchMin(claim[u], key) == INT_MAX) {
+                    mine.push_back(u);
+                }
+            }
+        }
+    });
+}
+
+/** claim unvisited vertices with an incoming edge from the frontier
+    order[begin..end-1] */
+void ParallelBfs::bottomUp(const CsrGraph& graph, int begin, int end,
+                           bool ordered) {
+    int n = graph.getNumVertices();
+    int words = (n + 63) / 64;
+    frontierBits.assign(words, 0);
+    for (int i = begin; i < end; ++i) {
+        int v = order[i];
+        frontierBits[v / 64] |= std::uint64_t(1) << (v % 64);
+    }
+
+    // each thread owns whole words of vertices, so claims are plain stores
+    pool.parallelFor(0, words, kWordGrain,
+        [&](int first, int last, int thread) {
+        std::vector<int>& mine = reached[thread];
+        int stop = std::min(last * 64, n);
+        for (int u = first * 64; u < stop; ++u) {
+            if (depth[u] >= 0) continue;
+            int best = INT_MAX;
+            for (int e = graph.inEdgeBegin(u); e < graph.inEdgeEnd(u); ++e) {
+                int v = graph.inEdgeSource(e);
+                if (!(frontierBits[v / 64] >> (v % 64) & 1)) continue;
+                if (!ordered) {
+                    // sources are sorted, the first one is the smallest
+                    best = v;
+                    break;
+                }
+                best = std::min(best, position[v]);
+            }
+            if (best != INT_MAX) {
+                claim[u].store(best, std::memory_order_relaxed);
+                mine.push_back(u);
+            }
+        }
+    });
+}
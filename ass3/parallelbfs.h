@@ -0,0 +1,82 @@
+/**
+ * Level-synchronous parallel breadth-first search on a CsrGraph
+ * Each level is expanded by the threads of a pool, either top-down
+ * (the frontier pushes along its outgoing edges) or bottom-up (every
+ * unvisited vertex looks for a parent in the frontier along its incoming
+ * edges, stopping at the first one). The direction is chosen per level
+ * from the edge counts, as in Beamer's direction-optimizing BFS: big
+ * frontiers on low-diameter graphs are much cheaper bottom-up
+ * The frontier is a list for top-down steps and a bitmap for bottom-up
+ * steps
+ * Parents are claimed with an atomic minimum, so the result does not
+ * depend on the number of threads or their timing:
+ * by default the parent is the smallest frontier id with an edge to the
+ * vertex; with ordered set it is the earliest one in visit order, and
+ * getOrder is exactly the order of CsrGraph::breadthFirstTraversal
+ */
+
+#ifndef PARALLELBFS_H
+#define PARALLELBFS_H
+
+#include <atomic>
+#include <cstdint>
+#include <vector>
+
+#include "csrgraph.h"
+#include "threadpool.h"
+
+class ParallelBfs {
+ public:
+    /** constructor, the levels are expanded on pool */
+    explicit ParallelBfs(ThreadPool& pool);
+
+    /** search from source
+        ordered makes parents and getOrder follow the sequential visit
+        order; bottom-up steps then read all incoming edges of a vertex
+        instead of stopping at the first parent */
+    void run(const CsrGraph& graph, int source, bool ordered = false);
+
+    /** hops from the last source, -1 if unreachable */
+    const std::vector<int>& getDepths() const;
+
+    /** vertex before each vertex on its shortest path, -1 if none */
+    const std::vector<int>& getParents() const;
+
+    /** reached vertices level by level
+        in visit order if run was ordered, else by id within a level */
+    const std::vector<int>& getOrder() const;
+
+    /** number of levels of the last run expanded bottom-up */
+    int getBottomUpSteps() const;
+
+ private:
+    ThreadPool& pool;
+
+    /** smallest parent key seen for each vertex, INT_MAX if none
+        the key is the parent's id, or its position in order if ordered */
+    std::vector<std::atomic<int>> claim;
+
+    /** result arrays of the last run */
+    std::vector<int> depth;
+    std::vector<int> parent;
+    std::vector<int> order;
+    int bottomUpSteps;
+
+    /** index of each reached vertex in order, only kept if ordered */
+    std::vector<int> position;
+
+    /** frontier as a bitmap, built for bottom-up steps */
+    std::vector<std::uint64_t> frontierBits;
+
+    /** vertices reached by each thread in the current step */
+    std::vector<std::vector<int>> reached;
+
+    /** claim the unvisited targets of frontier order[begin..end-1] */
+    void topDown(const CsrGraph& graph, int begin, int end, bool ordered);
+
+    /** claim unvisited vertices with an incoming edge from the frontier
+        order[begin..end-1] */
+    void bottomUp(const CsrGraph& graph, int begin, int end, bool ordered);
+};  // end ParallelBfs
+
+#endif  // PARALLELBFS_H
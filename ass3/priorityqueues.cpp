@@ -0,0 +1,181 @@
+#include <climits>
+
+#ifdef _MSC_VER
+#include <intrin.h>
+#endif
+
+#include "priorityqueues.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+/** constructor, empty heap */
+PairingHeap::PairingHeap() : root(-1) {}
+
+/** make room for ids 0..n-1, the heap must be empty */
+void PairingHeap::reserve(int n) {
+    if (static_cast<int>(keys.size()) < n) {
+        child.resize(n);
+        next.resize(n);
+        prev.resize(n);
+        keys.resize(n);
+        queued.resize(n, 0);
+    }
+}
+
+/** insert id, or lower its key if it is already queued */
+void PairingHeap::update(int id, int key) {
+    if (!queued[id]) {
+        queued[id] = 1;
+        keys[id] = key;
+        child[id] = next[id] = prev[id] = -1;
+        root = root < 0 ? id : meld(root, id);
+        return;
+    }
+    if (key >= keys[id]) return;
+    keys[id] = key;
+    if (id == root) return;
+
+    // cut the subtree of id out of its parent's child list
+    int before = prev[id];
+    if (child[before] == id) {
+        child[before] = next[id];
+    } else {
+        next[before] = next[id];
+    }
+    if (next[id] >= 0) {
+        prev[next[id]] = before;
+    }
+    next[id] = prev[id] = -1;
+    root = meld(root, id);
+}
+
+/** remove and return the id with the smallest key */
+int PairingHeap::pop() {
+    int top = root;
+    queued[top] = 0;
+
+    pairs.clear();
+    for (int c = child[top]; c >= 0;) {
+        int following = next[c];
+        next[c] = prev[c] = -1;
+        pairs.push_back(c);
+        c = following;
+    }
+
+    // two-pass merge: pair up left to right, then fold right to left
+    int count = static_cast<int>(pairs.size());
+    int kept = 0;
+    for (int i = 0; i + 1 < count; i += 2) {
+        pairs[kept++] = meld(pairs[i], pairs[i + 1]);
+    }
+    if (count % 2 == 1) {
+        pairs[kept++] = pairs[count - 1];
+    }
+    root = -1;
+    for (int i = kept - 1; i >= 0; --i) {
+        root = root < 0 ? pairs[i] : meld(pairs[i], root);
+    }
+    return top;
+}
+
+/** link two roots, return the new root */
+int PairingHeap::meld(int a, int b) {
+    if (keys[b] < keys[a]) {
+        int swap = a;
+        a = b;
+        b = swap;
+    }
+    // b becomes the leftmost child of a
+    next[b] = child[a];
+    if (child[a] >= 0) {
+        prev[child[a]] = b;
+    }
+    prev[b] = a;
+    child[a] = b;
+    return a;
+}
+
+/** constructor, empty heap */
+RadixHeap::RadixHeap() : last(0), live(0) {}
+
+/** make room for ids 0..n-1, the heap must be empty */
+void RadixHeap::reserve(int n) {
+    if (static_cast<int>(keys.size()) < n) {
+        keys.resize(n);
+        queued.resize(n, 0);
+    }
+    // outdated entries may be left over from the previous run
+    for (std::vector<Entry>& bucket : buckets) {
+        bucket.clear();
+    }
+    last = 0;
+}
+
+/** insert id, or lower its key if it is already queued */
+void RadixHeap::update(int id, int key) {
+    unsigned k = static_cast<unsigned>(key);
+    if (!queued[id]) {
+        queued[id] = 1;
+        ++live;
+    } else if (k >= keys[id]) {
+        return;
+    }
+    keys[id] = k;
+    buckets[bucketOf(k)].push_back({ k, id });
+}
+
+/** remove and return the id with the smallest key */
+int RadixHeap::pop() {
+    for (;;) {
+        std::vector<Entry>& front = buckets[0];
+        while (!front.empty()) {
+            Entry entry = front.back();
+            front.pop_back();
+            int id = entry.second;
+            if (queued[id] && keys[id] == entry.first) {
+                queued[id] = 0;
+                --live;
+                return id;
+            }
+        }
+
+        int i = 1;
+        while (buckets[i].empty()) ++i;
+        std::vector<Entry>& bucket = buckets[i];
+
+        // the smallest current key becomes last, the rest of the bucket
+        // then falls into strictly lower buckets
+        unsigned smallest = UINT_MAX;
+        for (const Entry& entry : bucket) {
+            if (queued[entry.second] && keys[entry.second] == entry.first &&
+                entry.first < smallest) {
+                smallest = entry.first;
+            }
+        }
+        if (smallest != UINT_MAX) {
+            last = smallest;
+            for (const Entry& entry : bucket) {
+                if (queued[entry.second] &&
+                    keys[entry.second] == entry.first) {
+                    buckets[bucketOf(entry.first)].push_back(entry);
+                }
+            }
+        }
+        bucket.clear();
+    }
+}
+
+/** bucket an entry with the given key belongs to */
+int RadixHeap::bucketOf(unsigned key) const {
+    unsigned diff = key ^ last;
+    if (diff == 0) return 0;
+#ifdef _MSC_VER
+    unsigned long bit;
+    _BitScanReverse(&bit, diff);
+    return static_cast<int>(bit) + 1;
+#else
+    return 32 - __builtin_clz(diff);
+#endif
+}
@@ -0,0 +1,210 @@
+/**
+ * Addressable min-priority queues over vertex ids, used by DijkstraEngine
+ * Every queue has the same interface:
+ *   reserve(n)       make room for ids 0..n-1, the queue must be empty
+ *   update(id, key)  insert id, or lower its key if it is already queued
+ *   empty()          true if no id is queued
+ *   pop()            remove and return the id with the smallest key
+ * Keys are ints, IndexedDaryHeap can take another key type;
+ * RadixHeap additionally needs keys that are not negative
+ * and never smaller than the last popped key, which holds for Dijkstra
+ * with non-negative edge weights
+ */
+
+#ifndef PRIORITYQUEUES_H
+#define PRIORITYQUEUES_H
+
+#include <utility>
+#include <vector>
+
+/** implicit d-ary heap with a position index for decrease-key
+    Arity 2 is the classic binary heap, 4 is usually faster in practice
+    because the tree is half as deep and children share cache lines
+    Key is the type of the keys, any type ordered by < */
+template <int Arity, class Key = int>
+class IndexedDaryHeap {
+ public:
+    /** make room for ids 0..n-1, the heap must be empty */
+    void reserve(int n) {
+        if (static_cast<int>(position.size()) < n) {
+            position.resize(n, -1);
+            keys.resize(n);
+        }
+    }
+
+    /** insert id, or lower its key if it is already queued */
+    void update(int id, Key key) {
+        int at = position[id];
+        if (at < 0) {
+            at = static_cast<int>(heap.size());
+            heap.push_back(id);
+        } else if (key >= keys[id]) {
+            return;
+        }
+        keys[id] = key;
+        siftUp(at, id);
+    }
+
+    /** true if no id is queued */
+    bool empty() const { return heap.empty(); }
+
+    /** smallest key, the heap must not be empty */
+    Key topKey() const { return keys[heap[0]]; }
+
+    /** remove every queued id, in time proportional to their number */
+    void clear() {
+        for (int id : heap) {
+            position[id] = -1;
+        }
+        heap.clear();
+    }
+
+    /** remove and return the id with the smallest key */
+    int pop() {
+        int top = heap[0];
+        position[top] = -1;
+        int last = heap.back();
+        heap.pop_back();
+        if (!heap.empty()) {
+            siftDown(0, last);
+        }
+        return top;
+    }
+
+ private:
+    /** ids in heap order */
+    std::vector<int> heap;
+
+    /** index of each id in heap, -1 if not queued */
+    std::vector<int> position;
+
+    /** current key of each queued id */
+    std::vector<Key> keys;
+
+    /** move id up from hole at until its parent is not larger */
+    void siftUp(int at, int id) {
+        Key key = keys[id];
+        while (at > 0) {
+            int parent = (at - 1) / Arity;
+            int parentId = heap[parent];
+            if (keys[parentId] <= key) break;
+            heap[at] = parentId;
+            position[parentId] = at;
+            at = parent;
+        }
+        heap[at] = id;
+        position[id] = at;
+    }
+
+    /** move id down from hole at until no child is smaller */
+    void siftDown(int at, int id) {
+        Key key = keys[id];
+        int size = static_cast<int>(heap.size());
+        for (;;) {
+            int first = at * Arity + 1;
+            if (first >= size) break;
+            int last = first + Arity < size ? first + Arity : size;
+            int best = first;
+            for (int c = first + 1; c < last; ++c) {
+                if (keys[heap[c]] < keys[heap[best]]) best = c;
+            }
+            if (keys[heap[best]] >= key) break;
+            heap[at] = heap[best];
+            position[heap[at]] = at;
+            at = best;
+        }
+        heap[at] = id;
+        position[id] = at;
+    }
+};  // end IndexedDaryHeap
+
+/** pairing heap with nodes stored in arrays indexed by id
+    constant time insert and decrease-key, amortized log n pop */
+class PairingHeap {
+ public:
+    /** constructor, empty heap */
+    PairingHeap();
+
+    /** make room for ids 0..n-1, the heap must be empty */
+    void reserve(int n);
+
+    /** insert id, or lower its key if it is already queued */
+    void update(int id, int key);
+
+    /** true if no id is queued */
+    bool empty() const { return root < 0; }
+
+    /** remove and return the id with the smallest key */
+    int pop();
+
+ private:
+    /** root of the heap, -1 if empty */
+    int root;
+
+    /** leftmost child of each node, -1 if none */
+    std::vector<int> child;
+
+    /** right sibling of each node, -1 if none */
+    std::vector<int> next;
+
+    /** left sibling, or parent for a leftmost child, -1 for the root */
+    std::vector<int> prev;
+
+    /** current key of each node */
+    std::vector<int> keys;
+
+    /** true if the id is queued */
+    std::vector<char> queued;
+
+    /** scratch list of subtrees for pop */
+    std::vector<int> pairs;
+
+    /** link two roots, return the new root */
+    int meld(int a, int b);
+};  // end PairingHeap
+
+/** monotone radix heap for non-negative keys
+    keys are bucketed by the highest bit in which they differ from the
+    last popped key, so every entry moves at most 32 times in total
+    update pushes a new entry, outdated entries are dropped lazily */
+class RadixHeap {
+ public:
+    /** constructor, empty heap */
+    RadixHeap();
+
+    /** make room for ids 0..n-1, the heap must be empty */
+    void reserve(int n);
+
+    /** insert id, or lower its key if it is already queued */
+    void update(int id, int key);
+
+    /** true if no id is queued */
+    bool empty() const { return live == 0; }
+
+    /** remove and return the id with the smallest key */
+    int pop();
+
+ private:
+    typedef std::pair<unsigned, int> Entry;
+
+    /** bucket 0 holds keys equal to last, bucket i keys whose highest
+        differing bit from last is bit i-1 */
+    std::vector<Entry> buckets[33];
+
+    /** the last popped key, all queued keys are at least this */
+    unsigned last;
+
+    /** number of queued ids, not counting outdated entries */
+    int live;
+
+    /** current key of each id */
+    std::vector<unsigned> keys;
+
+    /** true if the id is queued */
+    std::vector<char> queued;
+
+    /** bucket an entry with the given key belongs to */
+    int bucketOf(unsigned key) const;
+};  // end RadixHeap
+
+#endif  // PRIORITYQUEUES_H
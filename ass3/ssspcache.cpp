@@ -0,0 +1,128 @@
+#include <climits>
+#include <iterator>
+#include <utility>
+
+#include "ssspcache.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+const size_t SsspCache::kDefaultMemoryLimit;
+
+/** constructor, empty cache holding at most memoryLimit bytes */
+SsspCache::SsspCache(size_t memoryLimit) : memoryLimit(memoryLimit) {}
+
+/** return the most bytes held */
+size_t SsspCache::getMemoryLimit() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return memoryLimit;
+}
+
+/** change the most bytes held, 0 turns the cache off
+    drops trees until the cache fits */
+void SsspCache::setMemoryLimit(size_t memoryLimit) {
+    std::lock_guard<std::mutex> lock(mutex);
+    this->memoryLimit = memoryLimit;
+    shrinkTo(memoryLimit);
+}
+
+/** tree from source computed at version, nullptr if there is none
+    counts a hit or a miss, a hit becomes the most recently used
+    a tree of another version is stale and dropped */
+std::shared_ptr<const SsspResult> SsspCache::find(const std::string& source,
+                                                  uint64_t version) {
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = bySource.find(source);
+    if (found == bySource.end()) {
+        ++stats.misses;
+        return nullptr;
+    }
+    if (found->second->version != version) {
+        ++stats.misses;
+        ++stats.invalidations;
+        erase(found->second);
+        return nullptr;
+    }
+    ++stats.hits;
+    entries.splice(entries.begin(), entries, found->second);
+    return found->second->tree;
+}
+
+/** keep the tree from source computed at version, replacing any
+    older one; not kept if it is larger than the memory limit */
+void SsspCache::insert(const std::string& source, uint64_t version,
+                       std::shared_ptr<const SsspResult> tree) {
+    // the snapshot is shared with the graph, only the arrays count
+    size_t bytes = sizeof(int) * (tree->getDistances().capacity() +
+                                  tree->getParents().capacity()) +
+        sizeof(Entry) + source.size();
+    std::lock_guard<std::mutex> lock(mutex);
+    auto found = bySource.find(source);
+    if (found != bySource.end()) erase(found->second);
+    if (bytes > memoryLimit) return;
+    shrinkTo(memoryLimit - bytes);
+    entries.push_front({ source, version, std::move(tree), bytes });
+    bySource[source] = entries.begin();
+    stats.entries++;
+    stats.bytes += bytes;
+}
+
+/** the graph went from oldVersion to newVersion by a change to the
+    edges leaving from: trees that cannot reach from stay valid and
+    move to newVersion, the others are dropped, as are stale ones */
+void SsspCache::keepUnaffected(const std::string& from,
+                               uint64_t oldVersion, uint64_t newVersion) {
+    std::lock_guard<std::mutex> lock(mutex);
+    for (auto entry = entries.begin(); entry != entries.end();) {
+        auto next = std::next(entry);
+        if (entry->version == oldVersion &&
+            entry->tree->cost(from) == INT_MAX) {
+            entry->version = newVersion;
+        } else {
+            ++stats.invalidations;
+            erase(entry);
+        }
+        entry = next;
+    }
+}
+
+/** drop every tree, the counters are kept */
+void SsspCache::clear() {
+    std::lock_guard<std::mutex> lock(mutex);
+    entries.clear();
+    bySource.clear();
+    stats.entries = 0;
+    stats.bytes = 0;
+}
+
+/** return the counters */
+SsspCacheStats SsspCache::getStats() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return stats;
+}
+
+/** set hits, misses, evictions and invalidations back to 0 */
+void SsspCache::resetStats() {
+    std::lock_guard<std::mutex> lock(mutex);
+    stats.hits = 0;
+    stats.misses = 0;
+    stats.evictions = 0;
+    stats.invalidations = 0;
+}
+
+/** drop entry, mutex held */
+void SsspCache::erase(std::list<Entry>::iterator entry) {
+    stats.entries--;
+    stats.bytes -= entry->bytes;
+    bySource.erase(entry->source);
+    entries.erase(entry);
+}
+
+/** drop the least recently used trees until bytes fit, mutex held */
+void SsspCache::shrinkTo(size_t bytes) {
+    while (stats.bytes > bytes) {
+        ++stats.evictions;
+        erase(std::prev(entries.end()));
+    }
+}
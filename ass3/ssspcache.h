@@ -0,0 +1,116 @@
+/**
+ * Least-recently-used cache of shortest-path trees, by source label
+ * Each tree is stored with the graph version it was computed at and is
+ * only returned for that version, so any change to the graph makes
+ * every tree stale unless keepUnaffected carries it over: a change to
+ * the edges leaving a vertex cannot alter the costs from a source that
+ * does not reach that vertex
+ * The trees are shared, not copied, so a hit takes a hash lookup
+ * Memory is bounded by the bytes of the cost and parent arrays of the
+ * trees; the least recently used ones are dropped to stay under it
+ * All methods are thread safe
+ */
+
+#ifndef SSSPCACHE_H
+#define SSSPCACHE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "ssspresult.h"
+
+/** counters of an SsspCache */
+struct SsspCacheStats {
+    /** lookups answered from the cache */
+    long long hits {0};
+
+    /** lookups not answered, including stale trees */
+    long long misses {0};
+
+    /** trees dropped to stay under the memory limit */
+    long long evictions {0};
+
+    /** trees dropped because the graph changed under them */
+    long long invalidations {0};
+
+    /** trees held now */
+    size_t entries {0};
+
+    /** bytes held now */
+    size_t bytes {0};
+};
+
+class SsspCache {
+ public:
+    /** default memory limit, 256 MB */
+    static const size_t kDefaultMemoryLimit = size_t(256) << 20;
+
+    /** constructor, empty cache holding at most memoryLimit bytes */
+    explicit SsspCache(size_t memoryLimit = kDefaultMemoryLimit);
+
+    /** return the most bytes held */
+    size_t getMemoryLimit() const;
+
+    /** change the most bytes held, 0 turns the cache off
+        drops trees until the cache fits */
+    void setMemoryLimit(size_t memoryLimit);
+
+    /** tree from source computed at version, nullptr if there is none
+        counts a hit or a miss, a hit becomes the most recently used
+        a tree of another version is stale and dropped */
+    std::shared_ptr<const SsspResult> find(const std::string& source,
+                                           uint64_t version);
+
+    /** keep the tree from source computed at version, replacing any
+        older one; not kept if it is larger than the memory limit */
+    void insert(const std::string& source, uint64_t version,
+                std::shared_ptr<const SsspResult> tree);
+
+    /** the graph went from oldVersion to newVersion by a change to the
+        edges leaving from: trees that cannot reach from stay valid and
+        move to newVersion, the others are dropped, as are stale ones */
+    void keepUnaffected(const std::string& from, uint64_t oldVersion,
+                        uint64_t newVersion);
+
+    /** drop every tree, the counters are kept */
+    void clear();
+
+    /** return the counters */
+    SsspCacheStats getStats() const;
+
+    /** set hits, misses, evictions and invalidations back to 0 */
+    void resetStats();
+
+ private:
+    struct Entry {
+        std::string source;
+        uint64_t version;
+        std::shared_ptr<const SsspResult> tree;
+        size_t bytes;
+    };
+
+    /** most recently used first */
+    std::list<Entry> entries;
+
+    /** position of each source in entries */
+    std::unordered_map<std::string, std::list<Entry>::iterator> bySource;
+
+    size_t memoryLimit;
+    SsspCacheStats stats;
+
+    /** guards everything above */
+    mutable std::mutex mutex;
+
+    /** drop entry, mutex held */
+    void erase(std::list<Entry>::iterator entry);
+
+    /** drop the least recently used trees until bytes fit, mutex held */
+    void shrinkTo(size_t bytes);
+};  // end SsspCache
+
+#endif  // SSSPCACHE_H
@@ -0,0 +1,124 @@
+#include <algorithm>
+#include <climits>
+#include <utility>
+
+#include "ssspresult.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+/** constructor, no search: nothing is reached */
+SsspResult::SsspResult() : source(-1) {}
+
+/** result of a search from source on graph
+    distance[v] is the cost to v, INT_MAX if unreachable
+    parent[v] is the vertex before v, -1 for source and unreachable */
+SsspResult::SsspResult(std::shared_ptr<const CsrGraph> graph, int source,
+                       std::vector<int> distance, std::vector<int> parent)
+    : graph(std::move(graph)), source(source),
+      distance(std::move(distance)), parents(std::move(parent)) {}
+
+/** return the graph the ids belong to, nullptr if no search */
+const std::shared_ptr<const CsrGraph>& SsspResult::getGraph() const {
+    return graph;
+}
+
+/** return the source id, -1 if no search */
+int SsspResult::getSource() const { return source; }
+
+/** return number of vertices that can be reached, source included */
+int SsspResult::getNumReached() const {
+    return static_cast<int>(distance.size()) -
+        static_cast<int>(std::count(distance.begin(), distance.end(),
+                                    INT_MAX));
+}
+
+/** cost to vertex id, INT_MAX if it cannot be reached */
+int SsspResult::cost(int id) const {
+    if (id < 0 || id >= static_cast<int>(distance.size())) return INT_MAX;
+    return distance[id];
+}
+
+/** cost to label, INT_MAX if it cannot be reached or is not in the
+    graph */
+int SsspResult::cost(const std::string& label) const {
+    if (!graph) return INT_MAX;
+    return cost(graph->findVertex(label));
+}
+
+/** vertex before id on its shortest path, -1 if none */
+int SsspResult::parent(int id) const {
+    if (id < 0 || id >= static_cast<int>(parents.size())) return -1;
+    return parents[id];
+}
+
+/** ids on the shortest path to vertex id, source first, empty if
+    it cannot be reached; valid until this thread calls path again */
+SsspResult::PathView SsspResult::path(int id) const {
+    // one per thread, so results can be shared between threads
+    static thread_local std::vector<int> buffer;
+    return path(id, buffer);
+}
+
+/** ids on the shortest path to label, source first, empty if it
+    cannot be reached or is not in the graph; valid until this
+    thread calls path again */
+SsspResult::PathView SsspResult::path(const std::string& label) const {
+    return path(graph ? graph->findVertex(label) : -1);
+}
+
+/** path to label into the caller's buffer */
+SsspResult::PathView SsspResult::path(const std::string& label,
+                                      std::vector<int>& buffer) const {
+    return path(graph ? graph->findVertex(label) : -1, buffer);
+}
+
+/** path into the caller's buffer instead of the thread's, valid
+    until buffer changes */
+SsspResult::PathView SsspResult::path(int id,
+                                      std::vector<int>& buffer) const {
+    buffer.clear();
+    if (cost(id) != INT_MAX) {
+        for (int v = id; v >= 0; v = parents[v]) {
+            buffer.push_back(v);
+        }
+        std::reverse(buffer.begin(), buffer.end());
+    }
+    return PathView(buffer.data(), buffer.data() + buffer.size());
+}
+
+/** labels on the shortest path to label, source first */
+std::vector<std::string> SsspResult::pathLabels(
+    const std::string& label) const {
+    // the labels are copied anyway, so the ids need no shared buffer
+    std::vector<int> buffer;
+    std::vector<std::string> labels;
+    PathView ids = path(label, buffer);
+    labels.reserve(ids.size());
+    for (int id : ids) {
+        labels.push_back(graph->getLabel(id));
+    }
+    return labels;
+}
+
+/** label of vertex id */
+std::string SsspResult::label(int id) const { return graph->getLabel(id); }
+
+/** costs indexed by vertex id */
+const std::vector<int>& SsspResult::getDistances() const { return distance; }
+
+/** parents indexed by vertex id */
+const std::vector<int>& SsspResult::getParents() const { return parents; }
+
+/** fill the maps of djikstraCostToAllVertices, for callers that
+    need them; this is where all the labels get copied */
+void SsspResult::toMaps(std::map<std::string, int>& weight,
+                        std::map<std::string, std::string>& previous) const {
+    if (!graph || source < 0) {
+        weight.clear();
+        previous.clear();
+        return;
+    }
+    graph->fillCostMaps(source, distance, parents, weight, previous);
+}
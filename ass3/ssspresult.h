@@ -0,0 +1,115 @@
+/**
+ * Result of a single-source shortest-path search on a CsrGraph, kept as
+ * two arrays indexed by vertex id instead of the label maps filled by
+ * Graph::djikstraCostToAllVertices: 8 bytes per vertex, no tree nodes
+ * and no copied labels
+ * Labels are only produced when asked for, by label or pathLabels
+ * path rebuilds a path by walking the parent array into a buffer kept
+ * per thread, so repeated calls allocate nothing once it has grown to
+ * the longest path, and threads can share one result, as
+ * Graph::cachedShortestPathsFrom does; the path stays valid until the
+ * same thread calls path again. Callers can also pass their own buffer
+ * The result holds the snapshot it was computed on, so it stays valid
+ * while the Graph changes
+ */
+
+#ifndef SSSPRESULT_H
+#define SSSPRESULT_H
+
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "csrgraph.h"
+
+class SsspResult {
+ public:
+    /** vertex ids of a path, source first; points into the buffer of
+        the result, so it is only valid until the next call of path */
+    class PathView {
+     public:
+        PathView(const int* first, const int* last)
+            : first(first), last(last) {}
+        const int* begin() const { return first; }
+        const int* end() const { return last; }
+        int size() const { return static_cast<int>(last - first); }
+        bool empty() const { return first == last; }
+        int operator[](int i) const { return first[i]; }
+
+     private:
+        const int* first;
+        const int* last;
+    };
+
+    /** constructor, no search: nothing is reached */
+    SsspResult();
+
+    /** result of a search from source on graph
+        distance[v] is the cost to v, INT_MAX if unreachable
+        parent[v] is the vertex before v, -1 for source and unreachable */
+    SsspResult(std::shared_ptr<const CsrGraph> graph, int source,
+               std::vector<int> distance, std::vector<int> parent);
+
+    /** return the graph the ids belong to, nullptr if no search */
+    const std::shared_ptr<const CsrGraph>& getGraph() const;
+
+    /** return the source id, -1 if no search */
+    int getSource() const;
+
+    /** return number of vertices that can be reached, source included */
+    int getNumReached() const;
+
+    /** cost to vertex id, INT_MAX if it cannot be reached */
+    int cost(int id) const;
+
+    /** cost to label, INT_MAX if it cannot be reached or is not in the
+        graph */
+    int cost(const std::string& label) const;
+
+    /** vertex before id on its shortest path, -1 if none */
+    int parent(int id) const;
+
+    /** ids on the shortest path to vertex id, source first, empty if
+        it cannot be reached; valid until this thread calls path again */
+    PathView path(int id) const;
+
+    /** ids on the shortest path to label, source first, empty if it
+        cannot be reached or is not in the graph; valid until this
+        thread calls path again */
+    PathView path(const std::string& label) const;
+
+    /** path into the caller's buffer instead of the thread's, valid
+        until buffer changes */
+    PathView path(int id, std::vector<int>& buffer) const;
+
+    /** path to label into the caller's buffer */
+    PathView path(const std::string& label, std::vector<int>& buffer) const;
+
+    /** labels on the shortest path to label, source first */
+    std::vector<std::string> pathLabels(const std::string& label) const;
+
+    /** label of vertex id */
+    std::string label(int id) const;
+
+    /** costs indexed by vertex id */
+    const std::vector<int>& getDistances() const;
+
+    /** parents indexed by vertex id */
+    const std::vector<int>& getParents() const;
+
+    /** fill the maps of djikstraCostToAllVertices, for callers that
+        need them; this is where all the labels get copied */
+    void toMaps(std::map<std::string, int>& weight,
+                std::map<std::string, std::string>& previous) const;
+
+ private:
+    /** snapshot searched */
+    std::shared_ptr<const CsrGraph> graph;
+
+    int source;
+    std::vector<int> distance;
+    std::vector<int> parents;
+};  // end SsspResult
+
+#endif  // SSSPRESULT_H
@@ -0,0 +1,98 @@
+#include "threadpool.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+/** constructor, numThreads counts the calling thread
+    0 uses one thread per hardware core */
+ThreadPool::ThreadPool(int numThreads)
+    : body(nullptr), end(0), grain(1), next(0), generation(0), busy(0),
+      stopping(false) {
+    if (numThreads <= 0) {
+        numThreads = static_cast<int>(std::thread::hardware_concurrency());
+    }
+    if (numThreads <= 0) numThreads = 1;
+    for (int thread = 1; thread < numThreads; ++thread) {
+        workers.emplace_back(&ThreadPool::workerLoop, this, thread);
+    }
+}
+
+/** destructor, stops and joins the workers */
+ThreadPool::~ThreadPool() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (std::thread& worker : workers) {
+        worker.join();
+    }
+}
+
+/** return number of threads a loop runs on, including the caller */
+int ThreadPool::getNumThreads() const {
+    return static_cast<int>(workers.size()) + 1;
+}
+
+/** call body(first, last, thread) for consecutive chunks of at most
+    grain indices covering begin..end-1
+    thread is 0..getNumThreads()-1 and identifies the calling thread,
+    so body can use per-thread buffers without locking */
+void ThreadPool::parallelFor(int begin, int end, int grain,
+                             const std::function<void(int, int, int)>& body) {
+    if (begin >= end) return;
+    if (grain < 1) grain = 1;
+    std::lock_guard<std::mutex> loop(loopMutex);
+
+    // a single chunk is not worth waking anyone up for
+    if (workers.empty() || end - begin <= grain) {
+        body(begin, end, 0);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        this->body = &body;
+        this->end = end;
+        this->grain = grain;
+        next.store(begin);
+        busy = static_cast<int>(workers.size());
+        ++generation;
+    }
+    wake.notify_all();
+    runChunks(0);
+
+    std::unique_lock<std::mutex> lock(mutex);
+    finished.wait(lock, [this] { return busy == 0; });
+    this->body = nullptr;
+}
+
+/** body of each worker thread */
+void ThreadPool::workerLoop(int thread) {
+    unsigned seen = 0;
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            wake.wait(lock, [&] { return stopping || generation != seen; });
+            if (stopping) return;
+            seen = generation;
+        }
+        runChunks(thread);
+        {
+            std::lock_guard<std::mutex> lock(mutex);
+            --busy;
+        }
+        finished.notify_one();
+    }
+}
+
+/** take chunks of the current loop until there are none left */
+void ThreadPool::runChunks(int thread) {
+    for (;;) {
+        int first = next.fetch_add(grain);
+        if (first >= end) return;
+        int last = first + grain < end ? first + grain : end;
+        (*body)(first, last, thread);
+    }
+}
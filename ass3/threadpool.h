@@ -0,0 +1,73 @@
+/**
+ * Fixed set of worker threads for data-parallel loops
+ * parallelFor splits a range of indices into chunks that the workers and
+ * the calling thread take in turn until none are left, and returns once
+ * every chunk is done. Only one loop runs at a time, callers from other
+ * threads wait for the current loop to finish
+ */
+
+#ifndef THREADPOOL_H
+#define THREADPOOL_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class ThreadPool {
+ public:
+    /** constructor, numThreads counts the calling thread
+        0 uses one thread per hardware core */
+    explicit ThreadPool(int numThreads = 0);
+
+    /** destructor, stops and joins the workers */
+    ~ThreadPool();
+
+    ThreadPool(const ThreadPool&) = delete;
+    ThreadPool& operator=(const ThreadPool&) = delete;
+
+    /** return number of threads a loop runs on, including the caller */
+    int getNumThreads() const;
+
+    /** call body(first, last, thread) for consecutive chunks of at most
+        grain indices covering begin..end-1
+        thread is 0..getNumThreads()-1 and identifies the calling thread,
+        so body can use per-thread buffers without locking */
+    void parallelFor(int begin, int end, int grain,
+                     const std::function<void(int, int, int)>& body);
+
+ private:
+    std::vector<std::thread> workers;
+
+    /** held by the thread running a loop */
+    std::mutex loopMutex;
+
+    /** guards the fields below */
+    std::mutex mutex;
+    std::condition_variable wake;
+    std::condition_variable finished;
+
+    /** current loop */
+    const std::function<void(int, int, int)>* body;
+    int end;
+    int grain;
+    std::atomic<int> next;
+
+    /** bumped for each loop so workers notice new work */
+    unsigned generation;
+
+    /** workers still busy with the current loop */
+    int busy;
+
+    bool stopping;
+
+    /** body of each worker thread */
+    void workerLoop(int thread);
+
+    /** take chunks of the current loop until there are none left */
+    void runChunks(int thread);
+};  // end ThreadPool
+
+#endif  // THREADPOOL_H
@@ -0,0 +1,26 @@
+#include <algorithm>
+
+#include "traversalstate.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+/** constructor, no vertices */
+TraversalState::TraversalState() {}
+
+/** start a new query on a graph with numVertices vertices
+    all vertices become unvisited and the stats are cleared */
+void TraversalState::reset(int numVertices) {
+    if (static_cast<int>(marks.size()) < numVertices) {
+        marks.resize(numVertices, 0);
+    }
+    ++query;
+    // after 4 billion queries the counter wraps, old marks must go
+    if (query == 0) {
+        std::fill(marks.begin(), marks.end(), 0);
+        query = 1;
+    }
+    queue.clear();
+    if (kStatsEnabled) stats = QueryStats();
+}
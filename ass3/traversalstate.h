@@ -0,0 +1,65 @@
+/**
+ * Per-query bookkeeping for graph traversals
+ * Keeps the visited marks outside of the graph, indexed by vertex id,
+ * so a const graph can be searched by many threads at the same time,
+ * each thread using its own TraversalState
+ * Starting a new query is constant time: marks are stamped with a
+ * query number instead of being cleared
+ */
+
+#ifndef TRAVERSALSTATE_H
+#define TRAVERSALSTATE_H
+
+#include <vector>
+
+#include "querystats.h"
+#include "vertex.h"
+
+class TraversalState {
+ public:
+    /** constructor, no vertices */
+    TraversalState();
+
+    /** start a new query on a graph with numVertices vertices
+        all vertices become unvisited and the stats are cleared */
+    void reset(int numVertices);
+
+    /** return true if vertex id has been visited in this query */
+    bool isVisited(int id) const { return marks[id] == query; }
+
+    /** mark vertex id as visited in this query */
+    void visit(int id) { marks[id] = query; }
+
+    /** reusable work queue for breadth-first traversal */
+    std::vector<const Vertex*>& getQueue() { return queue; }
+
+    /** a vertex on the depth-first stack and its next edge to look at */
+    struct StackEntry {
+        const Vertex* vertex;
+        Vertex::NeighborRange::Iterator next;
+    };
+
+    /** reusable stack for depth-first traversal */
+    std::vector<StackEntry>& getStack() { return stack; }
+
+    /** work done by the current query, all zero unless kStatsEnabled */
+    QueryStats& getStats() { return stats; }
+
+    /** work done by the current query, all zero unless kStatsEnabled */
+    const QueryStats& getStats() const { return stats; }
+
+ private:
+    /** query number that last visited each vertex */
+    std::vector<unsigned> marks;
+
+    /** number of the current query, never 0 once reset is called */
+    unsigned query {0};
+
+    /** kept between queries so their memory is reused */
+    std::vector<const Vertex*> queue;
+    std::vector<StackEntry> stack;
+
+    QueryStats stats;
+};  // end TraversalState
+
+#endif  // TRAVERSALSTATE_H
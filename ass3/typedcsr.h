@@ -0,0 +1,251 @@
+/**
+ * Compact copy of a CsrGraph with the edge weights stored as a chosen
+ * type, for graphs whose weights are known to be small
+ * Targets and weights are separate arrays; targets are 32-bit ids and
+ * weights are Weight, so with uint16_t a relaxation reads 6 bytes of
+ * edge where CsrGraph reads 8
+ * Weight can be uint16_t, uint32_t, int64_t, float or UnitWeight;
+ * UnitWeight stores no weights at all, every edge costs 1
+ * Negative weights are never held, whatever the type
+ * TypedDijkstra is compiled for the weight type, path costs are kept in
+ * WeightTraits<Weight>::Distance, and for UnitWeight it is a
+ * breadth-first search with no heap
+ * Vertex ids are those of the CsrGraph the copy was made from, so its
+ * labels and findVertex still apply
+ */
+
+#ifndef TYPEDCSR_H
+#define TYPEDCSR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+#include "csrgraph.h"
+#include "priorityqueues.h"
+
+/** weight of a graph in which every edge costs 1 */
+struct UnitWeight {};
+
+/** how edges of type Weight are stored and added up */
+template <class Weight>
+struct WeightTraits {
+    /** type of path costs, wide enough for long paths */
+    typedef typename std::conditional<std::is_floating_point<Weight>::value,
+                                      double, std::int64_t>::type Distance;
+
+    /** true if weight is stored as Weight without change and is not
+        negative, which TypedDijkstra cannot search */
+    static bool holds(int weight) {
+        double value = weight;
+        return weight >= 0 &&
+            value <= double(std::numeric_limits<Weight>::max()) &&
+            value <= double(std::numeric_limits<Weight>::max()) &&
+            double(static_cast<Weight>(weight)) == value;
+    }
+
+    /** cost of edge e */
+    static Distance cost(const std::vector<Weight>& weights,
+                         std::uint32_t e) {
+        return weights[e];
+    }
+};  // end WeightTraits
+
+/** unit weights are not stored, a path costs its number of edges */
+template <>
+struct WeightTraits<UnitWeight> {
+    typedef int Distance;
+
+    static bool holds(int weight) { return weight == 1; }
+
+    static Distance cost(const std::vector<UnitWeight>&, std::uint32_t) {
+        return 1;
+    }
+};  // end WeightTraits<UnitWeight>
+
+template <class Weight>
+class TypedCsr {
+ public:
+    typedef typename WeightTraits<Weight>::Distance Distance;
+
+    /** constructor, empty graph */
+    TypedCsr() : offsets(1, 0) {}
+
+    /** return true if every weight of graph can be stored as Weight,
+        negative weights never can */
+    static bool canHold(const CsrGraph& graph) {
+        for (int e = 0; e < graph.getNumEdges(); ++e) {
+            if (!WeightTraits<Weight>::holds(graph.edgeWeight(e))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /** replace this graph by a copy of graph
+        return false if a weight cannot be stored as Weight or is
+        negative, this graph is then left unchanged */
+    bool assign(const CsrGraph& graph) {
+        if (!canHold(graph)) return false;
+        int n = graph.getNumVertices();
+        int m = graph.getNumEdges();
+        std::vector<std::uint32_t> newOffsets(n + 1);
+        std::vector<std::uint32_t> newTargets(m);
+        for (int v = 0; v <= n; ++v) {
+            newOffsets[v] = v < n ? graph.edgeBegin(v) : m;
+        }
+        for (int e = 0; e < m; ++e) {
+            newTargets[e] = graph.edgeTarget(e);
+        }
+        std::vector<Weight> newWeights;
+        if (!std::is_same<Weight, UnitWeight>::value) {
+            newWeights.resize(m);
+            for (int e = 0; e < m; ++e) {
+                newWeights[e] = fromInt(graph.edgeWeight(e));
+            }
+        }
+        offsets.swap(newOffsets);
+        targets.swap(newTargets);
+        weights.swap(newWeights);
+        return true;
+    }
+
+    /** return number of vertices */
+    int getNumVertices() const {
+        return static_cast<int>(offsets.size()) - 1;
+    }
+
+    /** return number of edges */
+    int getNumEdges() const { return static_cast<int>(targets.size()); }
+
+    /** first edge index of vertex id */
+    std::uint32_t edgeBegin(int id) const { return offsets[id]; }
+
+    /** one past the last edge index of vertex id */
+    std::uint32_t edgeEnd(int id) const { return offsets[id + 1]; }
+
+    /** vertex id the edge points to */
+    int edgeTarget(std::uint32_t edge) const { return targets[edge]; }
+
+    /** weight of the edge */
+    Distance edgeWeight(std::uint32_t edge) const {
+        return WeightTraits<Weight>::cost(weights, edge);
+    }
+
+    /** bytes of the offset, target and weight arrays */
+    size_t getMemoryBytes() const {
+        return sizeof(std::uint32_t) * (offsets.size() + targets.size()) +
+            sizeof(Weight) * weights.size();
+    }
+
+ private:
+    /** numVertices + 1 entries, edges of v are offsets[v]..offsets[v+1]-1 */
+    std::vector<std::uint32_t> offsets;
+
+    /** end vertex id of each edge */
+    std::vector<std::uint32_t> targets;
+
+    /** weight of each edge, empty for UnitWeight */
+    std::vector<Weight> weights;
+
+    /** weight as Weight, holds(weight) must be true */
+    static Weight fromInt(int weight) { return static_cast<Weight>(weight); }
+};  // end TypedCsr
+
+/** UnitWeight has no value to convert to, assign never stores one */
+template <>
+inline UnitWeight TypedCsr<UnitWeight>::fromInt(int) {
+    return UnitWeight();
+}
+
+/** single-source shortest paths on a TypedCsr, same layout of results
+    as DijkstraEngine: distance[v] is the cost from the source,
+    unreachable() if v cannot be reached, predecessor[v] the vertex
+    before v on a shortest path, -1 for the source and unreachable ones
+    edge weights must not be negative
+    an engine keeps its arrays between runs and is not thread safe */
+template <class Weight>
+class TypedDijkstra {
+ public:
+    typedef typename WeightTraits<Weight>::Distance Distance;
+
+    /** distance of a vertex that cannot be reached */
+    static Distance unreachable() {
+        return std::numeric_limits<Distance>::max();
+    }
+
+    /** compute the lowest cost from source to every vertex of graph */
+    void run(const TypedCsr<Weight>& graph, int source) {
+        if (!start(graph, source)) return;
+        heap.reserve(graph.getNumVertices());
+        heap.update(source, 0);
+        while (!heap.empty()) {
+            int v = heap.pop();
+            Distance cost = distance[v];
+            std::uint32_t last = graph.edgeEnd(v);
+            for (std::uint32_t e = graph.edgeBegin(v); e < last; ++e) {
+                int u = graph.edgeTarget(e);
+                Distance through = cost + graph.edgeWeight(e);
+                if (through < distance[u]) {
+                    distance[u] = through;
+                    predecessor[u] = v;
+                    heap.update(u, through);
+                }
+            }
+        }
+    }
+
+    /** cost from the last source, unreachable() if none */
+    const std::vector<Distance>& getDistances() const { return distance; }
+
+    /** previous vertex on the shortest path, -1 if none */
+    const std::vector<int>& getPredecessors() const { return predecessor; }
+
+ private:
+    /** result arrays of the last run */
+    std::vector<Distance> distance;
+    std::vector<int> predecessor;
+
+    /** queue of run, the heap for weighted graphs and a plain
+        first-in first-out array for unit weights */
+    IndexedDaryHeap<4, Distance> heap;
+    std::vector<int> queue;
+
+    /** reset the arrays for a run from source
+        return false if source is not a vertex of graph */
+    bool start(const TypedCsr<Weight>& graph, int source) {
+        int n = graph.getNumVertices();
+        distance.assign(n, unreachable());
+        predecessor.assign(n, -1);
+        if (source < 0 || source >= n) return false;
+        distance[source] = 0;
+        return true;
+    }
+};  // end TypedDijkstra
+
+/** with unit weights the first time a vertex is reached is by a
+    shortest path, so breadth-first order settles every vertex */
+template <>
+inline void TypedDijkstra<UnitWeight>::run(
+    const TypedCsr<UnitWeight>& graph, int source) {
+    if (!start(graph, source)) return;
+    queue.clear();
+    queue.push_back(source);
+    for (size_t next = 0; next < queue.size(); ++next) {
+        int v = queue[next];
+        Distance cost = distance[v] + 1;
+        std::uint32_t last = graph.edgeEnd(v);
+        for (std::uint32_t e = graph.edgeBegin(v); e < last; ++e) {
+            int u = graph.edgeTarget(e);
+            if (distance[u] == unreachable()) {
+                distance[u] = cost;
+                predecessor[u] = v;
+                queue.push_back(u);
+            }
+        }
+    }
+}
+
+#endif  // TYPEDCSR_H
@@ -0,0 +1,116 @@
+#include <algorithm>
+#include <utility>
+
+#include "versionedgraph.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+/** constructor, empty graph */
+VersionedGraph::VersionedGraph()
+    : current(std::make_shared<const GraphVersion>()) {}
+
+/** constructor, first version holds a copy of graph */
+VersionedGraph::VersionedGraph(const CsrGraph& graph) {
+    auto first = std::make_shared<GraphVersion>();
+    int n = graph.getNumVertices();
+    for (int v = 0; v < n; ++v) {
+        first->findOrAddVertex(graph.getLabel(v));
+    }
+    auto byLabel = [&first](const GraphVersion::Arc& a,
+                            const GraphVersion::Arc& b) {
+        return first->labels[a.vertex] < first->labels[b.vertex];
+    };
+    for (int v = 0; v < n; ++v) {
+        auto arcs = std::make_shared<std::vector<GraphVersion::Arc>>();
+        arcs->reserve(graph.edgeEnd(v) - graph.edgeBegin(v));
+        for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+            arcs->push_back({ graph.edgeTarget(e), graph.edgeWeight(e) });
+        }
+        // rows are in label order already unless graph was reordered
+        if (!std::is_sorted(arcs->begin(), arcs->end(), byLabel)) {
+            std::sort(arcs->begin(), arcs->end(), byLabel);
+        }
+        first->out.set(v, std::move(arcs));
+    }
+    first->numberOfEdges = graph.getNumEdges();
+    current = std::move(first);
+}
+
+/** return the current version, it does not change while held */
+std::shared_ptr<const GraphVersion> VersionedGraph::snapshot() const {
+    return std::atomic_load(&current);
+}
+
+/** return the number of the current version */
+std::uint64_t VersionedGraph::getVersion() const {
+    return snapshot()->getVersion();
+}
+
+/** add a new edge between start and end vertex
+    if the vertices do not exist, create them
+    return false and publish nothing for a self-loop or an edge
+    that already exists */
+bool VersionedGraph::add(const std::string& start, const std::string& end,
+                         int edgeWeight) {
+    if (start == end) return false;
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (current->hasEdge(start, end)) return false;
+    auto next = std::make_shared<GraphVersion>(*current);
+    next->setArc(next->findOrAddVertex(start), next->findOrAddVertex(end),
+                 edgeWeight);
+    publish(std::move(next));
+    return true;
+}
+
+/** add a batch of edges as one new version, same result as calling
+    add on each in turn, return how many were added */
+int VersionedGraph::addEdges(const std::vector<EdgeRecord>& edges) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    auto next = std::make_shared<GraphVersion>(*current);
+    int added = 0;
+    for (const EdgeRecord& edge : edges) {
+        if (edge.start == edge.end || next->hasEdge(edge.start, edge.end)) {
+            continue;
+        }
+        next->setArc(next->findOrAddVertex(edge.start),
+                     next->findOrAddVertex(edge.end), edge.weight);
+        added++;
+    }
+    if (added > 0) publish(std::move(next));
+    return added;
+}
+
+/** remove the edge from start to end
+    return false and publish nothing if there is no such edge */
+bool VersionedGraph::remove(const std::string& start,
+                            const std::string& end) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    int from = current->findVertex(start);
+    int to = current->findVertex(end);
+    if (from < 0 || to < 0) return false;
+    auto next = std::make_shared<GraphVersion>(*current);
+    if (!next->removeArc(from, to)) return false;
+    publish(std::move(next));
+    return true;
+}
+
+/** change the weight of the edge between start and end
+    return false and publish nothing if there is no such edge */
+bool VersionedGraph::setEdgeWeight(const std::string& start,
+                                   const std::string& end, int edgeWeight) {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    if (!current->hasEdge(start, end)) return false;
+    auto next = std::make_shared<GraphVersion>(*current);
+    next->setArc(next->findVertex(start), next->findVertex(end), edgeWeight);
+    publish(std::move(next));
+    return true;
+}
+
+/** make next the current version */
+void VersionedGraph::publish(std::shared_ptr<GraphVersion> next) {
+    next->version = current->version + 1;
+    std::atomic_store(&current,
+                      std::shared_ptr<const GraphVersion>(std::move(next)));
+}
@@ -0,0 +1,73 @@
+/**
+ * A directed, weighted graph that can be read while it is being changed
+ * Every change builds a new GraphVersion that shares all unchanged
+ * vertices with the one before and publishes it with an atomic pointer
+ * swap. Readers take a snapshot, a shared_ptr to the current version,
+ * and query it without locks; a writer never waits for readers and a
+ * reader never sees half of a change. Changes are made one at a time
+ * under a writer lock, and a version is freed with the last snapshot
+ * that holds it
+ * Same rules for edges as Graph: no self-loops and no second edge
+ * between the same two vertices
+ */
+
+#ifndef VERSIONEDGRAPH_H
+#define VERSIONEDGRAPH_H
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "csrgraph.h"
+#include "graph.h"
+#include "graphversion.h"
+
+class VersionedGraph {
+ public:
+    /** constructor, empty graph */
+    VersionedGraph();
+
+    /** constructor, first version holds a copy of graph */
+    explicit VersionedGraph(const CsrGraph& graph);
+
+    /** return the current version, it does not change while held */
+    std::shared_ptr<const GraphVersion> snapshot() const;
+
+    /** return the number of the current version */
+    std::uint64_t getVersion() const;
+
+    /** add a new edge between start and end vertex
+        if the vertices do not exist, create them
+        return false and publish nothing for a self-loop or an edge
+        that already exists */
+    bool add(const std::string& start, const std::string& end,
+             int edgeWeight);
+
+    /** add a batch of edges as one new version, same result as calling
+        add on each in turn, return how many were added */
+    int addEdges(const std::vector<EdgeRecord>& edges);
+
+    /** remove the edge from start to end
+        return false and publish nothing if there is no such edge */
+    bool remove(const std::string& start, const std::string& end);
+
+    /** change the weight of the edge between start and end
+        return false and publish nothing if there is no such edge */
+    bool setEdgeWeight(const std::string& start, const std::string& end,
+                       int edgeWeight);
+
+ private:
+    /** current version, read and replaced with the atomic shared_ptr
+        functions so readers never see a torn pointer */
+    std::shared_ptr<const GraphVersion> current;
+
+    /** held by writers while they build and publish a version */
+    std::mutex writeMutex;
+
+    /** make next the current version */
+    void publish(std::shared_ptr<GraphVersion> next);
+};  // end VersionedGraph
+
+#endif  // VERSIONEDGRAPH_H
@@ -6,6 +6,7 @@
 #include <functional>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "edge.h"
 
@@ -17,12 +18,21 @@
 
 /** Creates an unvisited vertex, gives it a label, and clears its
     adjacency list.
-    NOTE: A vertex must have a unique label that cannot be changed. */
-Vertex::Vertex(std::string label) { this->vertexLabel = label; }
+    NOTE: A vertex must have a unique label that cannot be changed.
+    The id is a dense index given by the graph, 0 .. n-1
+    The adjacency list is allocated from pool, if given */
+Vertex::Vertex(std::string label, int id, NodePool* pool)
+    : adjacencyList(EdgeMap::allocator_type(pool)) {
+    this->vertexLabel = label;
+    this->vertexId = id;
+}
 
 /** @return  The label of this vertex. */
 std::string Vertex::getLabel() const { return this->vertexLabel; }
 
+/** @return  The id of this vertex, used to index per-query state. */
+int Vertex::getId() const { return this->vertexId; }
+
 /** Marks this vertex as visited. */
 void Vertex::visit() { this->visited = true; }
 
@@ -40,22 +50,57 @@ bool Vertex::isVisited() const { return this->visited; }
  @return  True if the connection is successful. */
 bool Vertex::connect(const std::string& endVertex, const int edgeWeight) {
 
-    // Find the current vertex
-    std::map<std::string, Edge, std::less<std::string>>::iterator 
-        currentVertex = adjacencyList.find(vertexLabel);
-
-    // If the labels are the same or if the current vertex's edge end vertex
-    // is the same as the end vertex, it means it's already connected
-    if (endVertex == this->vertexLabel ||( currentVertex != adjacencyList.end() 
-        &&currentVertex->second.getEndVertex()
-== endVertex)){
+    // Cannot connect to itself, or twice to the same vertex
+    if (endVertex == this->vertexLabel ||
+        adjacencyList.find(endVertex) != adjacencyList.end()) {
         return false;
     }
 
-    // Create new edge
-    Edge* temp = new Edge(endVertex, edgeWeight);
-    this->adjacencyList.insert({endVertex, *temp});
-    return true; 
+    // Create new edge pointing at its key
+    auto it = this->adjacencyList.emplace(endVertex, Edge()).first;
+    it->second = Edge(it->first, edgeWeight);
+    return true;
+}
+
+/** Adds a batch of edges given in increasing order of end vertex.
+    Edges that already exist, repeat an end vertex or connect back
+    to itself are skipped. Each edge is inserted next to the one
+    before it, so the batch takes a single pass over the list.
+    The new edges are appended to added, if given.
+ @return  The number of edges added. */
+int Vertex::connectSorted(const std::vector<Edge>& edges,
+                          std::vector<const Edge*>* added) {
+    int count = 0;
+    auto position = adjacencyList.begin();
+    for (const Edge& edge : edges) {
+        const std::string& endVertex = edge.getEndVertex();
+        if (endVertex == this->vertexLabel) continue;
+        while (position != adjacencyList.end() &&
+               position->first < endVertex) {
+            ++position;
+        }
+        if (position != adjacencyList.end() && position->first == endVertex) {
+            continue;
+        }
+        // the new edge goes right before position, which stays valid
+        auto it = adjacencyList.emplace_hint(position, endVertex, Edge());
+        it->second = Edge(it->first, edge.getWeight());
+        if (added != nullptr) added->push_back(&it->second);
+        ++count;
+    }
+    return count;
+}
+
+/** Changes the weight of the edge between this vertex and the given
+    vertex. The weight before is stored in oldWeight, if given.
+ @return  True if the edge exists, otherwise nothing changes. */
+bool Vertex::setEdgeWeight(const std::string& endVertex, int edgeWeight,
+                           int* oldWeight) {
+    auto it = adjacencyList.find(endVertex);
+    if (it == adjacencyList.end()) return false;
+    if (oldWeight != nullptr) *oldWeight = it->second.getWeight();
+    it->second = Edge(it->first, edgeWeight);
+    return true;
 }
 
 /** Removes the edge between this vertex and the given one.
@@ -65,7 +110,11 @@ bool Vertex::disconnect(const std::string& endVertex) {
 
     // Found the item
     if (it != adjacencyList.end()) {
-        adjacencyList.erase(endVertex);
+        // Keep getNextNeighbor valid if it was about to return this edge
+        if (iterations > 0 && it == currentNeighbor) {
+            ++currentNeighbor;
+        }
+        adjacencyList.erase(it);
         return true;
     }
     
@@ -110,19 +159,23 @@ void Vertex::resetNeighbor() {
     Returns the vertex label if there are no more neighbors
  @return  The label of the vertex's next neighbor. */
 std::string Vertex::getNextNeighbor() {
-    int c = 0;
-    for (currentNeighbor = adjacencyList.begin(); currentNeighbor != adjacencyList.end(); currentNeighbor++)
-    {
-        if (c == iterations)
-        {
-            iterations++;
-            return currentNeighbor->second.getEndVertex();
-        }
-            c++;
+    // iterations is 0 at the start of a new pass over the neighbors
+    if (iterations == 0) {
+        currentNeighbor = adjacencyList.begin();
     }
-    iterations = 0;
-    return this->vertexLabel;
-   
+    if (currentNeighbor == adjacencyList.end()) {
+        iterations = 0;
+        return this->vertexLabel;
+    }
+    iterations++;
+    return (currentNeighbor++)->second.getEndVertex();
+}
+
+/** Gets all neighbors of this vertex, in alphabetical order.
+    Each step of the iteration is constant time.
+ @return  A range of the outgoing edges of this vertex. */
+Vertex::NeighborRange Vertex::neighbors() const {
+    return NeighborRange(adjacencyList);
 }
 
 void Vertex::setIterations()
@@ -12,19 +12,72 @@
 #include <functional>
 #include <map>
 #include <string>
+#include <vector>
 
 #include "edge.h"
+#include "nodepool.h"
 
 class Vertex {
  public:
+    /** adjacency list type, neighbors sorted alphabetically by label
+        each Edge points at its own key, the label is stored once */
+    typedef std::map<std::string, Edge, std::less<std::string>,
+                     PoolAllocator<std::pair<const std::string, Edge>>>
+        EdgeMap;
+
+    /** read-only range over the edges of a vertex
+        iterating yields const Edge&, no labels are copied
+        invalidated by connect/disconnect on the same vertex */
+    class NeighborRange {
+     public:
+        class Iterator {
+         public:
+            explicit Iterator(EdgeMap::const_iterator position)
+                : position(position) {}
+            const Edge& operator*() const { return position->second; }
+            const Edge* operator->() const { return &position->second; }
+            Iterator& operator++() {
+                ++position;
+                return *this;
+            }
+            bool operator!=(const Iterator& other) const {
+                return position != other.position;
+            }
+            bool operator==(const Iterator& other) const {
+                return position == other.position;
+            }
+
+         private:
+            EdgeMap::const_iterator position;
+        };
+
+        explicit NeighborRange(const EdgeMap& edges) : edges(edges) {}
+        Iterator begin() const { return Iterator(edges.begin()); }
+        Iterator end() const { return Iterator(edges.end()); }
+        int size() const { return static_cast<int>(edges.size()); }
+
+     private:
+        const EdgeMap& edges;
+    };
+
     /** Creates an unvisited vertex, gives it a label, and clears its
         adjacency list.
-        NOTE: A vertex must have a unique label that cannot be changed. */
-    explicit Vertex(std::string label);
+        NOTE: A vertex must have a unique label that cannot be changed.
+        The id is a dense index given by the graph, 0 .. n-1
+        The adjacency list is allocated from pool, if given */
+    explicit Vertex(std::string label, int id = 0,
+                    NodePool* pool = nullptr);
+
+    /** The edges point into the adjacency list, so it is not copied */
+    Vertex(const Vertex&) = delete;
+    Vertex& operator=(const Vertex&) = delete;
 
     /** @return  The label of this vertex. */
     std::string getLabel() const;
 
+    /** @return  The id of this vertex, used to index per-query state. */
+    int getId() const;
+
     /** Marks this vertex as visited. */
     void visit();
 
@@ -42,6 +95,21 @@ class Vertex {
      @return  True if the connection is successful. */
     bool connect(const std::string& endVertex, const int edgeWeight = 0);
 
+    /** Adds a batch of edges given in increasing order of end vertex.
+        Edges that already exist, repeat an end vertex or connect back
+        to itself are skipped. Each edge is inserted next to the one
+        before it, so the batch takes a single pass over the list.
+        The new edges are appended to added, if given.
+     @return  The number of edges added. */
+    int connectSorted(const std::vector<Edge>& edges,
+                      std::vector<const Edge*>* added = nullptr);
+
+    /** Changes the weight of the edge between this vertex and the given
+        vertex. The weight before is stored in oldWeight, if given.
+     @return  True if the edge exists, otherwise nothing changes. */
+    bool setEdgeWeight(const std::string& endVertex, int edgeWeight,
+                       int* oldWeight = nullptr);
+
     /** Removes the edge between this vertex and the given one.
     @return  True if the removal is successful. */
     bool disconnect(const std::string& endVertex);
@@ -64,6 +132,11 @@ class Vertex {
      @return  The label of the vertex's next neighbor. */
     std::string getNextNeighbor();
 
+    /** Gets all neighbors of this vertex, in alphabetical order.
+        Each step of the iteration is constant time.
+     @return  A range of the outgoing edges of this vertex. */
+    NeighborRange neighbors() const;
+
     /** Sees whether this vertex is equal to another one.
         Two vertices are equal if they have the same label. */
     bool operator==(const Vertex& rightHandItem) const;
@@ -78,16 +151,19 @@ class Vertex {
     /** the unique label for the vertex */
     std::string vertexLabel;
 
+    /** dense index of the vertex in its graph */
+    int vertexId {0};
+
     /** True if the vertex is visited */
     bool visited {false};
 
     int iterations = 0;
 
     /** adjacencyList as an ordered map, in alphabetical order */
-    std::map<std::string, Edge, std::less<std::string>> adjacencyList;
+    EdgeMap adjacencyList;
 
     /** iterator showing which neighbor we are currently at */
-    std::map<std::string, Edge>::iterator currentNeighbor;
+    EdgeMap::iterator currentNeighbor;
 };
 
 #endif  // VERTEX_H
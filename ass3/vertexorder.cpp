@@ -0,0 +1,109 @@
+#include <algorithm>
+#include <cstdlib>
+#include <numeric>
+
+#include "vertexorder.h"
+
+////////////////////////////////////////////////////////////////////////////////
+// This is 80 characters - Keep all lines under 80 characters                 //
+////////////////////////////////////////////////////////////////////////////////
+
+namespace {
+
+/** number of edges at vertex v, in either direction */
+int degree(const CsrGraph& graph, int v) {
+    return graph.edgeEnd(v) - graph.edgeBegin(v) + graph.inEdgeEnd(v) -
+        graph.inEdgeBegin(v);
+}
+
+/** breadth-first order over the edges in both directions, every
+    component in turn, starting each from the next unvisited vertex of
+    starts; byDegree visits the neighbors of a vertex from lowest
+    degree up, as Cuthill-McKee does */
+std::vector<int> undirectedBfs(const CsrGraph& graph,
+                               const std::vector<int>& starts,
+                               bool byDegree) {
+    int n = graph.getNumVertices();
+    std::vector<char> visited(n, 0);
+    std::vector<int> queue;
+    queue.reserve(n);
+    std::vector<int> neighbors;
+    for (int start : starts) {
+        if (visited[start]) continue;
+        visited[start] = 1;
+        queue.push_back(start);
+        for (size_t head = queue.size() - 1; head < queue.size(); ++head) {
+            int v = queue[head];
+            neighbors.clear();
+            for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+                neighbors.push_back(graph.edgeTarget(e));
+            }
+            for (int e = graph.inEdgeBegin(v); e < graph.inEdgeEnd(v); ++e) {
+                neighbors.push_back(graph.inEdgeSource(e));
+            }
+            if (byDegree) {
+                std::stable_sort(neighbors.begin(), neighbors.end(),
+                                 [&graph](int a, int b) {
+                                     return degree(graph, a) <
+                                         degree(graph, b);
+                                 });
+            }
+            for (int u : neighbors) {
+                if (!visited[u]) {
+                    visited[u] = 1;
+                    queue.push_back(u);
+                }
+            }
+        }
+    }
+    return queue;
+}
+
+}  // namespace
+
+/** return every vertex id of graph once, in the given order
+    position i holds the id that becomes vertex i */
+std::vector<int> computeVertexOrder(const CsrGraph& graph,
+                                    VertexOrder order) {
+    int n = graph.getNumVertices();
+    std::vector<int> ids(n);
+    std::iota(ids.begin(), ids.end(), 0);
+    switch (order) {
+    case VertexOrder::Label:
+        for (int rank = 0; rank < n; ++rank) {
+            ids[rank] = graph.vertexByLabel(rank);
+        }
+        return ids;
+    case VertexOrder::Bfs:
+        return undirectedBfs(graph, ids, false);
+    case VertexOrder::Degree:
+        std::stable_sort(ids.begin(), ids.end(), [&graph](int a, int b) {
+            return degree(graph, a) > degree(graph, b);
+        });
+        return ids;
+    case VertexOrder::ReverseCuthillMcKee: {
+        // each component starts from a vertex of lowest degree, which
+        // tends to lie on its rim and gives long, narrow BFS levels
+        std::stable_sort(ids.begin(), ids.end(), [&graph](int a, int b) {
+            return degree(graph, a) < degree(graph, b);
+        });
+        std::vector<int> result = undirectedBfs(graph, ids, true);
+        std::reverse(result.begin(), result.end());
+        return result;
+    }
+    }
+    return ids;
+}
+
+/** average distance between the ids of the two ends of an edge,
+    lower means neighbors are closer together in memory */
+double averageEdgeSpan(const CsrGraph& graph) {
+    if (graph.getNumEdges() == 0) return 0;
+    double total = 0;
+    for (int v = 0; v < graph.getNumVertices(); ++v) {
+        for (int e = graph.edgeBegin(v); e < graph.edgeEnd(v); ++e) {
+            total += std::abs(graph.edgeTarget(e) - v);
+        }
+    }
+    return total / graph.getNumEdges();
+}
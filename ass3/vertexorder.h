@@ -0,0 +1,23 @@
+/**
+ * Vertex numberings that place vertices near the vertices they are
+ * joined to, so a traversal of the renumbered CsrGraph touches fewer
+ * cache lines; used by CsrGraph::reorder
+ * Edge direction is ignored: an edge joins its two vertices both ways
+ */
+
+#ifndef VERTEXORDER_H
+#define VERTEXORDER_H
+
+#include <vector>
+
+#include "csrgraph.h"
+
+/** return every vertex id of graph once, in the given order
+    position i holds the id that becomes vertex i */
+std::vector<int> computeVertexOrder(const CsrGraph& graph, VertexOrder order);
+
+/** average distance between the ids of the two ends of an edge,
+    lower means neighbors are closer together in memory */
+double averageEdgeSpan(const CsrGraph& graph);
+
+#endif  // VERTEXORDER_H